@@ -4,6 +4,9 @@
 #include <ctime>
 #include <cstdio>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
 using namespace std;
 
 /* ṹ */
@@ -44,8 +47,11 @@ void uniquify(CVec& v) {           //
     sort(v.begin(), v.end());
     v.erase(unique(v.begin(), v.end()), v.end());
 }
+inline double normKey(const Complex& c) {        //ģƽģͬҲÿ
+    return c.re * c.re + c.im * c.im;
+}
 bool cmpNorm(const Complex& a, const Complex& b) {         //ģ
-    double na = a.norm(), nb = b.norm();
+    double na = normKey(a), nb = normKey(b);
     if (na != nb) return na < nb;
     return a.re < b.re;
 }
@@ -71,6 +77,180 @@ void mergeSort(CVec& v, int l, int r) {          //
         v[l + k] = tmp[k];
 }
 
+/* Ӧ鲢TimSort ˼·ȶʶе/Σ̶öֲ벹 minRun
+   ջȹϲϲǰȲõȷλõβȡͬһʱñԾ
+   ֻһλ */
+class TimSorter {
+    CVec& a;
+    CVec buf;                      //һԤΪ nϲʱ
+    vector<pair<size_t, size_t> > runs;          //(, )
+    size_t minGallop;
+    enum { MIN_MERGE = 64, MIN_GALLOP = 7 };
+
+    static size_t minRunLength(size_t n) {
+        size_t r = 0;
+        while (n >= MIN_MERGE) { r |= n & 1; n >>= 1; }
+        return n + r;
+    }
+    size_t countRun(size_t lo, size_t hi) {      // lo Ȼγȣϸξ͵طת
+        size_t r = lo + 1;
+        if (r == hi) return 1;
+        if (cmpNorm(a[r], a[lo])) {
+            while (r < hi && cmpNorm(a[r], a[r - 1])) ++r;
+            reverse(a.begin() + lo, a.begin() + r);
+        } else {
+            while (r < hi && !cmpNorm(a[r], a[r - 1])) ++r;
+        }
+        return r - lo;
+    }
+    void binaryInsertion(size_t lo, size_t hi, size_t start) {   //[lo, start) 
+        for (size_t i = start; i < hi; ++i) {
+            Complex x = a[i];
+            CVec::iterator pos = upper_bound(a.begin() + lo, a.begin() + i, x, cmpNorm);
+            copy_backward(pos, a.begin() + i, a.begin() + i + 1);
+            *pos = x;
+        }
+    }
+    static size_t gallopUpper(const Complex& key, const Complex* p, size_t n) {   //p в key ǰ׺
+        size_t ofs = 0, step = 1;
+        while (ofs + step <= n && !cmpNorm(key, p[ofs + step - 1])) { ofs += step; step <<= 1; }
+        return upper_bound(p + ofs, p + min(n, ofs + step), key, cmpNorm) - p;
+    }
+    static size_t gallopLower(const Complex& key, const Complex* p, size_t n) {   //p С key ǰ׺
+        size_t ofs = 0, step = 1;
+        while (ofs + step <= n && cmpNorm(p[ofs + step - 1], key)) { ofs += step; step <<= 1; }
+        return lower_bound(p + ofs, p + min(n, ofs + step), key, cmpNorm) - p;
+    }
+    void merge(size_t lo, size_t mid, size_t hi) {
+        Complex* p = &a[0];
+        lo = upper_bound(p + lo, p + mid, p[mid], cmpNorm) - p;          //οͷҶԪصѾλ
+        if (lo == mid) return;
+        hi = lower_bound(p + mid, p + hi, p[mid - 1], cmpNorm) - p;      //ҶνβСĩԪصѾλ
+        buf.assign(p + lo, p + mid);
+        const Complex* l = &buf[0];
+        size_t i = 0, n1 = mid - lo, j = mid, d = lo;
+        while (i < n1 && j < hi) {
+            size_t winL = 0, winR = 0;
+            while (i < n1 && j < hi && winL < minGallop && winR < minGallop) {     //Ƚ
+                if (cmpNorm(p[j], l[i])) { p[d++] = p[j++]; ++winR; winL = 0; }
+                else { p[d++] = l[i++]; ++winL; winR = 0; }
+            }
+            if (i == n1 || j == hi) break;
+            for (;;) {             //Ծģʽһΰһ
+                size_t c1 = gallopUpper(p[j], l + i, n1 - i);
+                copy(l + i, l + i + c1, p + d);
+                i += c1; d += c1;
+                if (i == n1) break;
+                p[d++] = p[j++];
+                if (j == hi) break;
+                size_t c2 = gallopLower(l[i], p + j, hi - j);
+                copy(p + j, p + j + c2, p + d);
+                j += c2; d += c2;
+                if (j == hi) break;
+                p[d++] = l[i++];
+                if (i == n1) break;
+                if (minGallop > 1) --minGallop;
+                if (c1 < MIN_GALLOP && c2 < MIN_GALLOP) break;
+            }
+            minGallop += 2;        //Ծͣٴνż
+        }
+        copy(l + i, l + n1, p + d);                //Ҷʣಿֱԭλ
+    }
+    void mergeAt(size_t k) {
+        merge(runs[k].first, runs[k + 1].first, runs[k + 1].first + runs[k + 1].second);
+        runs[k].second += runs[k + 1].second;
+        runs.erase(runs.begin() + k + 1);
+    }
+    void mergeCollapse() {         //ά len[k-2] > len[k-1] + len[k]  len[k-1] > len[k]
+        while (runs.size() > 1) {
+            size_t k = runs.size() - 2;
+            if ((k > 0 && runs[k - 1].second <= runs[k].second + runs[k + 1].second) ||
+                (k > 1 && runs[k - 2].second <= runs[k - 1].second + runs[k].second)) {
+                if (runs[k - 1].second < runs[k + 1].second) --k;
+            } else if (runs[k].second > runs[k + 1].second) {
+                break;
+            }
+            mergeAt(k);
+        }
+    }
+public:
+    explicit TimSorter(CVec& v) : a(v), minGallop(MIN_GALLOP) {}
+    void sort() {
+        size_t n = a.size();
+        if (n < 2) return;
+        buf.reserve(n);
+        size_t minRun = minRunLength(n);
+        for (size_t lo = 0; lo < n; ) {
+            size_t len = countRun(lo, n);
+            if (len < minRun) {
+                size_t force = min(minRun, n - lo);
+                binaryInsertion(lo, lo + force, lo + len);
+                len = force;
+            }
+            runs.push_back(make_pair(lo, len));
+            mergeCollapse();
+            lo += len;
+        }
+        while (runs.size() > 1) {
+            size_t k = runs.size() - 2;
+            if (k > 0 && runs[k - 1].second < runs[k + 1].second) --k;
+            mergeAt(k);
+        }
+    }
+};
+void timSort(CVec& v) {            //ȶ򣬿滻 mergeSort
+    TimSorter(v).sort();
+}
+
+/* ÿԪֻһμ (, ±) һ԰ Complex
+   Ǹ double λģʽ޷Ƚֵͬ򣬿ֱӵļ */
+struct NormKey {
+    unsigned long long key;        //ģƽλģʽ
+    unsigned idx;                  //ԭ±
+};
+struct ByRe {                      //ͬģʱʵ cmpNorm һ
+    const CVec* v;
+    bool operator()(const NormKey& a, const NormKey& b) const {
+        return (*v)[a.idx].re < (*v)[b.idx].re;
+    }
+};
+void radixSortKeys(vector<NormKey>& a, vector<NormKey>& buf) {       //LSD ÿ 16 λ
+    const int D = 16, R = 1 << D, P = 64 / D;
+    size_t n = a.size();
+    vector<size_t> cnt((size_t)P * R, 0);
+    for (size_t i = 0; i < n; ++i)               //һɨͳȫ 4 ˵ֱͼ
+        for (int p = 0; p < P; ++p)
+            ++cnt[p * R + ((a[i].key >> (p * D)) & (R - 1))];
+    for (int p = 0; p < P; ++p) {
+        size_t* c = &cnt[p * R];
+        if (c[(a[0].key >> (p * D)) & (R - 1)] == n) continue;      //һλȫͬ
+        size_t s = 0;
+        for (int d = 0; d < R; ++d) { size_t t = c[d]; c[d] = s; s += t; }
+        for (size_t i = 0; i < n; ++i)
+            buf[c[(a[i].key >> (p * D)) & (R - 1)]++] = a[i];
+        a.swap(buf);
+    }
+}
+void normSort(CVec& v) {           // sort(..., cmpNorm) ȼ
+    size_t n = v.size();
+    if (n < 1024) { sort(v.begin(), v.end(), cmpNorm); return; }    //ģСʱֱͼ
+    vector<NormKey> a(n), buf(n);
+    for (size_t i = 0; i < n; ++i) {
+        double k = normKey(v[i]);
+        memcpy(&a[i].key, &k, sizeof k);
+        a[i].idx = (unsigned)i;
+    }
+    radixSortKeys(a, buf);
+    ByRe byRe = { &v };
+    for (size_t i = 0, j; i < n; i = j) {        //ģͬһٰʵ
+        for (j = i + 1; j < n && a[j].key == a[i].key; ++j);
+        if (j - i > 1) sort(a.begin() + i, a.begin() + j, byRe);
+    }
+    CVec out(n);
+    for (size_t i = 0; i < n; ++i) out[i] = v[a[i].idx];
+    v.swap(out);
+}
+
 /* Χ */
 CVec rangeFind(const CVec& v, double m1, double m2) {
     CVec res;
@@ -78,10 +258,285 @@ CVec rangeFind(const CVec& v, double m1, double m2) {
         double n = v[i].norm();
         if (n >= m1 && n < m2) res.push_back(v[i]);
     }
-    sort(res.begin(), res.end(), cmpNorm);
+    normSort(res);
     return res;
 }
 
+/* ϣĸԪţпѰַ̽⣩¼Ԫ±
+   ظԪأÿԪظռһۣɾĩβԪλλɾúƷĹ
+   ͬʱ 32 λϣֵ̽ʱȱȹϣݺͺʱҲػͷԪ */
+class HashCVec {
+    struct Slot {
+        unsigned idx;              //Ԫ±꣬EMPTY ʾղ
+        unsigned hash;
+    };
+    CVec v;
+    vector<Slot> slot;
+    size_t mask;
+    static const unsigned EMPTY = 0xffffffffu;
+    static unsigned hashOf(const Complex& c) {
+        double r = c.re + 0.0, i = c.im + 0.0;   //-0.0  0.0 ȣϣҲͬ
+        unsigned long long a, b;
+        memcpy(&a, &r, sizeof a);
+        memcpy(&b, &i, sizeof b);
+        unsigned long long h = a * 0x9E3779B97F4A7C15ULL ^ b;
+        h ^= h >> 32;              //λβΪ 0ȰѸλ
+        h *= 0xC2B2AE3D27D4EB4FULL;
+        return (unsigned)(h >> 32);
+    }
+    void place(unsigned idx, unsigned h) {
+        size_t s = h & mask;
+        while (slot[s].idx != EMPTY) s = (s + 1) & mask;
+        slot[s].idx = idx;
+        slot[s].hash = h;
+    }
+    void rehash(size_t cap) {
+        vector<Slot> old(cap);
+        old.swap(slot);
+        for (size_t s = 0; s < cap; ++s) slot[s].idx = EMPTY;
+        mask = cap - 1;
+        for (size_t s = 0; s < old.size(); ++s)
+            if (old[s].idx != EMPTY) place(old[s].idx, old[s].hash);
+    }
+    size_t findSlot(const Complex& c) const {    //زۺţҲ slot.size()
+        unsigned h = hashOf(c);
+        for (size_t s = h & mask; slot[s].idx != EMPTY; s = (s + 1) & mask)
+            if (slot[s].hash == h && v[slot[s].idx] == c) return s;
+        return slot.size();
+    }
+    void removeSlot(size_t s) {                  //ɾ̽ϺĲŲؿλ
+        size_t j = s;
+        for (;;) {
+            slot[s].idx = EMPTY;
+            for (;;) {
+                j = (j + 1) & mask;
+                if (slot[j].idx == EMPTY) return;
+                size_t h = slot[j].hash & mask;
+                if (((j - h) & mask) >= ((j - s) & mask)) break;   //h  (s, j] ڣŲ s
+            }
+            slot[s] = slot[j];
+            s = j;
+        }
+    }
+public:
+    HashCVec() : mask(0) { rehash(16); }
+    explicit HashCVec(const CVec& a) : v(a), mask(0) {
+        size_t cap = 16;
+        while (cap < 2 * v.size()) cap <<= 1;    //װӲ 1/2
+        rehash(cap);
+        for (size_t i = 0; i < v.size(); ++i) place((unsigned)i, hashOf(v[i]));
+    }
+    size_t size() const { return v.size(); }
+    const Complex& operator[](size_t i) const { return v[i]; }
+    const CVec& data() const { return v; }
+    void push_back(const Complex& c) {
+        if (2 * (v.size() + 1) > slot.size()) rehash(slot.size() * 2);
+        v.push_back(c);
+        place((unsigned)(v.size() - 1), hashOf(c));
+    }
+    bool contains(const Complex& c) const { return findSlot(c) != slot.size(); }
+    long find(const Complex& c) const {          //ĳ c Ԫ±꣬û򷵻 -1
+        size_t s = findSlot(c);
+        return s == slot.size() ? -1 : (long)slot[s].idx;
+    }
+    bool erase(const Complex& c) {               //ɾһ c ԪأĩβԪλ
+        size_t s = findSlot(c);
+        if (s == slot.size()) return false;
+        unsigned i = slot[s].idx, last = (unsigned)(v.size() - 1);
+        removeSlot(s);
+        if (i != last) {
+            size_t t = hashOf(v[last]) & mask;
+            while (slot[t].idx != last) t = (t + 1) & mask;
+            slot[t].idx = i;
+            v[i] = v[last];
+        }
+        v.pop_back();
+        return true;
+    }
+    void uniquify() {              //ϣȥأÿֵ״γֵλ˳
+        CVec all;
+        all.swap(v);
+        for (size_t s = 0; s < slot.size(); ++s) slot[s].idx = EMPTY;
+        for (size_t i = 0; i < all.size(); ++i) {
+            unsigned h = hashOf(all[i]);
+            size_t s = h & mask;
+            while (slot[s].idx != EMPTY && !(slot[s].hash == h && v[slot[s].idx] == all[i]))
+                s = (s + 1) & mask;
+            if (slot[s].idx != EMPTY) continue;  //ѳֹ
+            v.push_back(all[i]);
+            slot[s].idx = (unsigned)(v.size() - 1);
+            slot[s].hash = h;
+        }
+    }
+};
+
+const unsigned HashCVec::EMPTY;
+
+/* ɾdels ÿԪɾ pts һγ֣Ԫرԭ˳ */
+void removeBatch(CVec& pts, CVec& dels) {
+    if (dels.empty()) return;
+    sort(dels.begin(), dels.end());
+    vector<char> used(dels.size(), 0);
+    size_t w = 0;
+    for (size_t i = 0; i < pts.size(); ++i) {
+        size_t k = lower_bound(dels.begin(), dels.end(), pts[i]) - dels.begin();
+        while (k < dels.size() && dels[k] == pts[i] && used[k]) ++k;
+        if (k < dels.size() && dels[k] == pts[i]) { used[k] = 1; continue; }
+        pts[w++] = pts[i];
+    }
+    pts.resize(w);
+    dels.clear();
+}
+
+/* ֻͼԪأ commit ʧЧ */
+struct CSpan {
+    const Complex* first;
+    size_t n;
+    size_t size() const { return n; }
+    const Complex& operator[](size_t i) const { return first[i]; }
+    const Complex* begin() const { return first; }
+    const Complex* end() const { return first + n; }
+};
+
+/* ģԪذ cmpNorm źã[m1, m2) βѯֻζ
+   Ȼ棬commit ʱɾ壬һԹ鲢 */
+class NormIndex {
+    CVec pts;                      // cmpNorm 
+    vector<double> keys;           //pts[i] ģƽ
+    CVec adds, dels;               //ύĲɾ
+    void rebuildKeys() {
+        keys.resize(pts.size());
+        for (size_t i = 0; i < pts.size(); ++i) keys[i] = normKey(pts[i]);
+    }
+    size_t lowerNorm(double m) const {           //׸ģ >= m λãж norm() >= m һ
+        size_t l = 0, r = keys.size();
+        while (l < r) {
+            size_t mid = (l + r) >> 1;
+            if (sqrt(keys[mid]) < m) l = mid + 1; else r = mid;
+        }
+        return l;
+    }
+public:
+    explicit NormIndex(const CVec& v) : pts(v) { normSort(pts); rebuildKeys(); }
+    size_t size() const { return pts.size(); }
+    CSpan range(double m1, double m2) const {    // rangeFind(v, m1, m2) ͬ
+        size_t lo = lowerNorm(m1), hi = max(lo, lowerNorm(m2));
+        CSpan s = { pts.data() + lo, hi - lo };
+        return s;
+    }
+    void insert(const Complex& c) { adds.push_back(c); }
+    void erase(const Complex& c) { dels.push_back(c); }
+    void commit() {
+        removeBatch(pts, dels);
+        if (!adds.empty()) {
+            normSort(adds);
+            CVec merged(pts.size() + adds.size());
+            merge(pts.begin(), pts.end(), adds.begin(), adds.end(), merged.begin(), cmpNorm);
+            pts.swap(merged);
+            adds.clear();
+        }
+        rebuildKeys();
+    }
+};
+
+/* ƽ kd ʽ洢 [l, r) еΪָ㣬ż㰴ʵ㰴鲿з
+    <= ָ㣬Ұ >= ָ㣻 LEAF Ԫʱֱɨ */
+class KdTree {
+    CVec pts;
+    CVec adds, dels;
+    enum { LEAF = 16 };
+    static bool byRe(const Complex& a, const Complex& b) { return a.re < b.re; }
+    static bool byIm(const Complex& a, const Complex& b) { return a.im < b.im; }
+    static double axis(const Complex& c, int d) { return d ? c.im : c.re; }
+    static double dist2(const Complex& a, const Complex& b) {
+        double dx = a.re - b.re, dy = a.im - b.im;
+        return dx * dx + dy * dy;
+    }
+    typedef pair<double, size_t> Cand;           //(ƽ, ±)ѱǰ k 
+
+    void build(size_t l, size_t r, int d) {
+        if (r - l <= LEAF) return;
+        size_t m = (l + r) >> 1;
+        nth_element(pts.begin() + l, pts.begin() + m, pts.begin() + r, d ? byIm : byRe);
+        build(l, m, !d);
+        build(m + 1, r, !d);
+    }
+    void rectRec(size_t l, size_t r, int d, const Complex& lo, const Complex& hi, CVec& out) const {
+        if (r - l <= LEAF) {
+            for (size_t i = l; i < r; ++i)
+                if (inRect(pts[i], lo, hi)) out.push_back(pts[i]);
+            return;
+        }
+        size_t m = (l + r) >> 1;
+        double s = axis(pts[m], d);
+        if (inRect(pts[m], lo, hi)) out.push_back(pts[m]);
+        if (axis(lo, d) <= s) rectRec(l, m, !d, lo, hi, out);
+        if (axis(hi, d) >= s) rectRec(m + 1, r, !d, lo, hi, out);
+    }
+    void diskRec(size_t l, size_t r, int d, const Complex& c, double r2, CVec& out) const {
+        if (r - l <= LEAF) {
+            for (size_t i = l; i < r; ++i)
+                if (dist2(pts[i], c) <= r2) out.push_back(pts[i]);
+            return;
+        }
+        size_t m = (l + r) >> 1;
+        double diff = axis(c, d) - axis(pts[m], d);
+        if (dist2(pts[m], c) <= r2) out.push_back(pts[m]);
+        if (diff <= 0 || diff * diff <= r2) diskRec(l, m, !d, c, r2, out);
+        if (diff >= 0 || diff * diff <= r2) diskRec(m + 1, r, !d, c, r2, out);
+    }
+    void offer(priority_queue<Cand>& h, size_t k, const Complex& c, size_t i) const {
+        double d2 = dist2(pts[i], c);
+        if (h.size() < k) h.push(Cand(d2, i));
+        else if (d2 < h.top().first) { h.pop(); h.push(Cand(d2, i)); }
+    }
+    void knnRec(size_t l, size_t r, int d, const Complex& c, size_t k, priority_queue<Cand>& h) const {
+        if (r - l <= LEAF) {
+            for (size_t i = l; i < r; ++i) offer(h, k, c, i);
+            return;
+        }
+        size_t m = (l + r) >> 1;
+        double diff = axis(c, d) - axis(pts[m], d);
+        offer(h, k, c, m);
+        if (diff <= 0) knnRec(l, m, !d, c, k, h);          //߲ѯһ
+        else knnRec(m + 1, r, !d, c, k, h);
+        if (h.size() < k || diff * diff < h.top().first) {
+            if (diff <= 0) knnRec(m + 1, r, !d, c, k, h);
+            else knnRec(l, m, !d, c, k, h);
+        }
+    }
+public:
+    explicit KdTree(const CVec& v) : pts(v) { build(0, pts.size(), 0); }
+    size_t size() const { return pts.size(); }
+    static bool inRect(const Complex& p, const Complex& lo, const Complex& hi) {
+        return p.re >= lo.re && p.re <= hi.re && p.im >= lo.im && p.im <= hi.im;
+    }
+    void rect(const Complex& lo, const Complex& hi, CVec& out) const {     //վ [lo, hi]
+        out.clear();
+        rectRec(0, pts.size(), 0, lo, hi, out);
+    }
+    void disk(const Complex& c, double rad, CVec& out) const {             //|p - c| <= rad
+        out.clear();
+        diskRec(0, pts.size(), 0, c, rad * rad, out);
+    }
+    void knn(const Complex& c, size_t k, CVec& out) const {                //ɽԶ
+        out.clear();
+        if (k == 0) return;
+        priority_queue<Cand> h;
+        knnRec(0, pts.size(), 0, c, k, h);
+        out.resize(h.size());
+        for (size_t i = h.size(); i-- > 0; h.pop()) out[i] = pts[h.top().second];
+    }
+    void insert(const Complex& c) { adds.push_back(c); }
+    void erase(const Complex& c) { dels.push_back(c); }
+    void commit() {                //ɾ壬Ȼؽ
+        removeBatch(pts, dels);
+        pts.insert(pts.end(), adds.begin(), adds.end());
+        adds.clear();
+        build(0, pts.size(), 0);
+    }
+};
+
 /* ʱ */
 double tick(const CVec& data, void (*f)(CVec&), string name) {
     CVec cp = data;
@@ -97,11 +552,224 @@ double tickMerge(const CVec& data) {
     mergeSort(cp, 0, (int)cp.size() - 1);
     double t = (clock() - st) * 1000.0 / CLOCKS_PER_SEC;
     cout << "mergeSort ʱ: " << t << " ms\n";
+    cp = data;
+    st = clock();
+    timSort(cp);
+    t = (clock() - st) * 1000.0 / CLOCKS_PER_SEC;
+    cout << "timSort ʱ: " << t << " ms\n";
     return t;
 }
 
+/* ģԱ */
+void stdSortNorm(CVec& v) { sort(v.begin(), v.end(), cmpNorm); }
+bool sameNormOrder(const CVec& a, const CVec& b) {        //cmpNorm µȼۼΪͬ
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (normKey(a[i]) != normKey(b[i]) || a[i].re != b[i].re) return false;
+    return true;
+}
+void benchNormSort(size_t n) {
+    CVec D(n);
+    for (size_t i = 0; i < n; ++i)
+        D[i] = Complex((rand() % 200000 - 100000) / 100.0, (rand() % 200000 - 100000) / 100.0);
+    cout << "\n--- N=" << n << " ---\n";
+    tick(D, stdSortNorm, " sort(cmpNorm)");
+    tickMerge(D);
+    tick(D, normSort, " normSort");
+    CVec x = D, y = D;
+    stdSortNorm(x);
+    normSort(y);
+    cout << "normSort  sort(cmpNorm) " << (sameNormOrder(x, y) ? "һ" : "һ") << "\n";
+    x = D;
+    y = D;
+    stable_sort(x.begin(), x.end(), cmpNorm);
+    timSort(y);
+    cout << "timSort  stable_sort(cmpNorm) " << (x == y ? "һ" : "һ") << "\n";
+    tick(x, stdSortNorm, "˳ sort(cmpNorm)");
+    tick(x, normSort, "˳ normSort");
+    tickMerge(x);
+    reverse(x.begin(), x.end());
+    cout << " ";
+    tickMerge(x);
+}
+
+/* ΧԱȣɨΪ */
+double randCoord() { return (rand() % 200000 - 100000) / 100.0; }
+double msSince(clock_t st) { return (clock() - st) * 1000.0 / CLOCKS_PER_SEC; }
+bool sameSet(CVec a, CVec b) {
+    sort(a.begin(), a.end());
+    sort(b.begin(), b.end());
+    return a == b;
+}
+void benchIndex(size_t n, int q) {
+    CVec P(n);
+    for (size_t i = 0; i < n; ++i) P[i] = Complex(randCoord(), randCoord());
+    cout << "\n--- Χ N=" << n << "ÿѯ " << q << "  ---\n";
+    clock_t st = clock();
+    NormIndex ni(P);
+    cout << "NormIndex : " << msSince(st) << " ms\n";
+    st = clock();
+    KdTree kd(P);
+    cout << "KdTree : " << msSince(st) << " ms\n";
+
+    const int CHECK = 20;          //ǰɴβѯ뱩˶
+    bool ok = true;
+    size_t hits = 0;
+    CVec out, ref;
+    st = clock();
+    for (int t = 0; t < q; ++t) {
+        double m1 = rand() % 140000 / 100.0, m2 = m1 + rand() % 1000 / 100.0;
+        CSpan sp = ni.range(m1, m2);
+        hits += sp.size();
+        if (t < CHECK) ok = ok && sameNormOrder(CVec(sp.begin(), sp.end()), rangeFind(P, m1, m2));
+    }
+    double t1 = msSince(st);
+    st = clock();
+    for (int t = 0; t < CHECK; ++t) rangeFind(P, 1.0 * t, t + 5.0);
+    double t0 = msSince(st) / CHECK;
+    cout << " [m1,m2): rangeFind " << t0 << " ms/ΣNormIndex " << t1 * 1000 / q
+         << " us/Σ˶ԣƽ " << hits / q << "\n";
+
+    hits = 0;
+    st = clock();
+    for (int t = 0; t < q; ++t) {
+        Complex lo(randCoord(), randCoord()), hi(lo.re + rand() % 2000 / 100.0, lo.im + rand() % 2000 / 100.0);
+        kd.rect(lo, hi, out);
+        hits += out.size();
+        if (t < CHECK) {
+            ref.clear();
+            for (size_t i = 0; i < n; ++i) if (KdTree::inRect(P[i], lo, hi)) ref.push_back(P[i]);
+            ok = ok && sameSet(out, ref);
+        }
+    }
+    cout << "βѯ: " << msSince(st) * 1000 / q << " us/Σ˶ԣƽ " << hits / q << "\n";
+
+    hits = 0;
+    st = clock();
+    for (int t = 0; t < q; ++t) {
+        Complex c(randCoord(), randCoord());
+        double rad = rand() % 1000 / 100.0;
+        kd.disk(c, rad, out);
+        hits += out.size();
+        if (t < CHECK) {
+            ref.clear();
+            for (size_t i = 0; i < n; ++i) {
+                double dx = P[i].re - c.re, dy = P[i].im - c.im;
+                if (dx * dx + dy * dy <= rad * rad) ref.push_back(P[i]);
+            }
+            ok = ok && sameSet(out, ref);
+        }
+    }
+    cout << "Բ̲ѯ: " << msSince(st) * 1000 / q << " us/Σ˶ԣƽ " << hits / q << "\n";
+
+    const size_t K = 10;
+    st = clock();
+    for (int t = 0; t < q; ++t) {
+        Complex c(randCoord(), randCoord());
+        kd.knn(c, K, out);
+        if (t < CHECK) {           //Ƚϵ k ľ뼴ɣͬĵѡ
+            vector<double> d(n);
+            for (size_t i = 0; i < n; ++i)
+                d[i] = (P[i].re - c.re) * (P[i].re - c.re) + (P[i].im - c.im) * (P[i].im - c.im);
+            nth_element(d.begin(), d.begin() + K - 1, d.end());
+            Complex f = out.back();
+            ok = ok && out.size() == K &&
+                 (f.re - c.re) * (f.re - c.re) + (f.im - c.im) * (f.im - c.im) == d[K - 1];
+        }
+    }
+    cout << "k ڲѯ (k=" << K << "): " << msSince(st) * 1000 / q << " us/Σ˶ԣ\n";
+
+    const int B = 10000;           //£ɾ B е㣬 B µ
+    CVec del(P.begin(), P.begin() + B);
+    for (int i = 0; i < B; ++i) {
+        Complex c(randCoord(), randCoord());
+        ni.erase(del[i]); kd.erase(del[i]);
+        ni.insert(c); kd.insert(c);
+        P.push_back(c);
+    }
+    st = clock();
+    ni.commit();
+    double tn = msSince(st);
+    st = clock();
+    kd.commit();
+    cout << " " << B << " ɾ + " << B << " : NormIndex " << tn << " msKdTree "
+         << msSince(st) << " ms\n";
+    removeBatch(P, del);
+    ok = ok && ni.size() == P.size() && kd.size() == P.size();
+    CSpan sp = ni.range(100.0, 101.0);
+    ok = ok && sameNormOrder(CVec(sp.begin(), sp.end()), rangeFind(P, 100.0, 101.0));
+    Complex lo(-50, -50), hi(50, 50);
+    kd.rect(lo, hi, out);
+    ref.clear();
+    for (size_t i = 0; i < P.size(); ++i) if (KdTree::inRect(P[i], lo, hi)) ref.push_back(P[i]);
+    ok = ok && sameSet(out, ref);
+    cout << "뱩ɨ˶" << (ok ? "һ" : "һ") << "\n";
+}
+
+/* ϣԱȣCVec ϵ find / eraseFirst / uniquify Ϊ */
+void benchHash(size_t n) {
+    CVec D(n);
+    for (size_t i = 0; i < n; ++i)
+        D[i] = Complex((rand() % 4000 - 2000) / 100.0, (rand() % 4000 - 2000) / 100.0);
+    cout << "\n--- ϣ N=" << n << " ---\n";
+    const int LQ = 100, HQ = 1000000;            //԰汾ֻ̫
+    CVec keys(HQ);
+    for (int i = 0; i < HQ; ++i)                 //һУһ벻
+        keys[i] = i % 2 ? D[rand() % n] : Complex(randCoord() + 0.005, randCoord());
+
+    clock_t st = clock();
+    CVec V;
+    for (size_t i = 0; i < n; ++i) V.push_back(D[i]);
+    double tIns = msSince(st);
+    st = clock();
+    size_t found = 0;
+    for (int i = 0; i < LQ; ++i) found += find(V.begin(), V.end(), keys[i]) != V.end();
+    double tFind = msSince(st) / LQ;
+    st = clock();
+    for (int i = 0; i < LQ; ++i) eraseFirst(V, keys[i]);
+    double tErase = msSince(st) / LQ;
+    st = clock();
+    uniquify(V);
+    double tUniq = msSince(st);
+    cout << "CVec:      " << tIns << " msfind " << tFind * 1000 << " us/ΣeraseFirst "
+         << tErase * 1000 << " us/Σuniquify " << tUniq << " ms\n";
+
+    st = clock();
+    HashCVec H;
+    for (size_t i = 0; i < n; ++i) H.push_back(D[i]);
+    tIns = msSince(st);
+    st = clock();
+    size_t hFound = 0;
+    for (int i = 0; i < HQ; ++i) hFound += H.contains(keys[i]);
+    tFind = msSince(st) / HQ;
+    st = clock();
+    for (int i = 0; i < LQ; ++i) H.erase(keys[i]);          // CVec ɾͬԪأں˶
+    for (int i = LQ; i < HQ; ++i) H.erase(keys[i]);
+    tErase = msSince(st) / HQ;
+    st = clock();
+    H.uniquify();
+    tUniq = msSince(st);
+    cout << "HashCVec:  " << tIns << " msfind " << tFind * 1000 << " us/Σerase "
+         << tErase * 1000 << " us/Σuniquify " << tUniq << " ms\n";
+
+    CVec R = D;                    //գͬɾÿ key һγֺȥ
+    removeBatch(R, keys);
+    uniquify(R);
+    cout << " " << found << "/" << LQ << "  " << hFound << "/" << HQ << "ȥؽ CVec 汾"
+         << (sameSet(R, H.data()) ? "һ" : "һ") << "\n";
+}
+
 /*  */
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {      // job1_1 --bench [normSort ģ]
+        benchIndex(1000000, 100000);
+        benchHash(10000000);
+        cout << "\n=====  normSort ģԱ =====\n";
+        size_t maxN = argc > 2 ? (size_t)atof(argv[2]) : 10000000;     //ɴ 1e8Լ 6GB ڴ
+        for (size_t n = 1000000; n <= maxN; n *= 10) benchNormSort(n);
+        return 0;
+    }
+
     const int N = 10000;
     CVec A;
     srand(time(0));
@@ -125,30 +793,44 @@ int main() {
     bool ok = eraseFirst(A, ins);
     cout << "ɾ " << ins << (ok ? " ɹ" : " ʧ") << "size = " << A.size() << "\n";
 
+    HashCVec HA(A);
+    HA.push_back(ins);
+    cout << "HashCVec  key " << (HA.contains(key) ? "ҵ" : "δҵ") << "ɾ " << ins
+         << (HA.erase(ins) ? " ɹ" : " ʧ") << "size = " << HA.size() << "\n";
+    HA.uniquify();
+
     uniquify(A);
-    cout << "Ψһ size = " << A.size() << "\n";
+    cout << "Ψһ size = " << A.size() << "HashCVec ȥغ size = " << HA.size() << "\n";
 
     CVec Test = A;
     cout << "\n===== ܱȽ (N=" << Test.size() << ") =====\n";
 
-    sort(Test.begin(), Test.end(), cmpNorm);
+    normSort(Test);
     tick(Test, bubbleSort, "˳ bubbleSort");
     tickMerge(Test);
+    tick(Test, normSort, "˳ normSort");
 
     shuffleVec(Test);
     tick(Test, bubbleSort, " bubbleSort");
     tickMerge(Test);
+    tick(Test, normSort, " normSort");
 
-    sort(Test.rbegin(), Test.rend(), cmpNorm);
+    normSort(Test);
+    reverse(Test.begin(), Test.end());
     tick(Test, bubbleSort, " bubbleSort");
     tickMerge(Test);
+    tick(Test, normSort, " normSort");
 
-    sort(A.begin(), A.end(), cmpNorm);
+    normSort(A);
     double m1 = 5.0, m2 = 10.0;
     CVec sub = rangeFind(A, m1, m2);
     cout << "\nΧ [" << m1 << "," << m2 << ") ҵ "
          << sub.size() << " Ԫ\n";
     printVec(CVec(sub.begin(), sub.begin() + min(10, (int)sub.size())), "sub");
+    NormIndex idx(A);
+    CSpan span = idx.range(m1, m2);
+    cout << "NormIndex ֲѯ " << span.size() << " Ԫأ"
+         << (sameNormOrder(CVec(span.begin(), span.end()), sub) ? " rangeFind һ\n" : " rangeFind һ\n");
 
     return 0;
 }
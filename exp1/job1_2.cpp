@@ -4,24 +4,64 @@
 #include <cstdlib>
 #include <cmath>
 #include <cctype>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <string_view>
+#include <charconv>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <random>
+#include <limits>
 using namespace std;
 
-/* ˳ջ */
-template <typename T>
+/* ͳ operator new ֵ֤·䡣ֻڲԹ滻ȫַ亯
+   g++ -DCOUNT_ALLOC ...ĬϹ滻̳߳ءճ߱׼ķ */
+#ifdef COUNT_ALLOC
+static atomic<size_t> g_allocCount(0);
+__attribute__((noinline)) void* operator new(size_t n) {
+    g_allocCount.fetch_add(1, memory_order_relaxed);
+    void* p = malloc(n ? n : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { free(p); }
+#endif
+
+/* ˳ջǰ N Ԫشڶڲ󰴱Ǩϣ */
+template <typename T, int N = 32>
 class Stack {
 public:
-    explicit Stack(int sz = 200) {
-        elem = new T[sz];
-        top  = -1;
-        capacity = sz;
+    explicit Stack(int sz = N) : elem(buf), top(-1), capacity(N) {
+        if (sz > N) grow(sz);
     }
-    ~Stack() { delete [] elem; }
+    ~Stack() { if (elem != buf) delete [] elem; }
+    Stack(Stack&& o) : elem(buf), top(-1), capacity(N) { take(o); }
+    Stack& operator=(Stack&& o) {
+        if (this != &o) {
+            if (elem != buf) delete [] elem;
+            elem = buf; top = -1; capacity = N;
+            take(o);
+        }
+        return *this;
+    }
+    Stack(const Stack&) = delete;
+    Stack& operator=(const Stack&) = delete;
 
     bool empty() const { return top == -1; }
-    bool full()  const { return top == capacity - 1; }
+    bool full()  const { return top == capacity - 1; }   //  push 
+    int  size()  const { return top + 1; }
 
     void push(const T& x) {
-        if (full()) throw "ջ";
+        if (full()) grow(2 * capacity);
         elem[++top] = x;
     }
     T pop() {
@@ -33,14 +73,33 @@ public:
         return elem[top];
     }
 private:
+    T buf[N];
     T* elem;
     int top;
     int capacity;
+
+    void grow(int cap) {
+        T* p = new T[cap];
+        for (int i = 0; i <= top; ++i) p[i] = std::move(elem[i]);
+        if (elem != buf) delete [] elem;
+        elem = p;
+        capacity = cap;
+    }
+    void take(Stack& o) {               // ϴ洢ֱӽӹܣڲ洢ƶ
+        if (o.elem != o.buf) {
+            elem = o.elem; capacity = o.capacity;
+            o.elem = o.buf; o.capacity = N;
+        } else {
+            for (int i = 0; i <= o.top; ++i) buf[i] = std::move(o.buf[i]);
+        }
+        top = o.top;
+        o.top = -1;
+    }
 };
 
 #define N_OPTR 9
 typedef enum {ADD,SUB,MUL,DIV,POW,FAC,L_P,R_P,EOE} Operator;
-const char pri[N_OPTR][N_OPTR] = {
+constexpr char pri[N_OPTR][N_OPTR] = {   // ڣce::compile
 /* ջ \ ǰ    +   -   *   /   ^   !   (   )   \0 */
 /*      + */    {'>','>','<','<','<','<','<','>','>'},
 /*      - */    {'>','>','<','<','<','<','<','>','>'},
@@ -53,7 +112,7 @@ const char pri[N_OPTR][N_OPTR] = {
 /*     \0 */    {'<','<','<','<','<','<','<',' ','='}
 };
 
-int op2idx(char c) {
+constexpr int op2idx(char c) {
     switch (c) {
     case '+': return ADD;
     case '-': return SUB;
@@ -70,7 +129,7 @@ int op2idx(char c) {
 }
 
 /* ϵ   */
-int relOp(char r) {
+constexpr int relOp(char r) {
     if (r == '<') return 1;
     if (r == '=') return 2;
     if (r == '>') return 3;
@@ -85,10 +144,19 @@ double calc(double a, char op, double b) {
     case '/':
         if (fabs(b) < 1e-12) throw "";
         return a / b;
+    case '^': return pow(a, b);
     }
     throw "Ƿ˫Ŀ";
 }
 
+/* ׺һԪ !  0..170 ж壬171! ѳ double
+   ޶Χת int ȽϣתNaN Ҳڵһֵܾͬ */
+constexpr bool factArg(double a) { return a >= 0 && a <= 170 && a == (double)(int)a; }
+double fact(double a) {
+    if (!factArg(a)) throw "׳˲Ƿ";
+    return tgamma(a + 1);
+}
+
 double str2double(const string& s) {
     return strtod(s.c_str(), NULL);
 }
@@ -117,58 +185,122 @@ string preprocess(const string& in) {
     return out;
 }
 
-/* ʽֵ */
-double evaluate(const string& expr);
+/* һԪ */
+enum FuncId { F_SIN, F_COS, F_TAN, F_LOG, F_LN, F_SQRT, N_FUNC };
+constexpr const char* funcName[N_FUNC] = { "sin", "cos", "tan", "log", "ln", "sqrt" };
 
-/* һԪ */
-double callFunc(const string& name, double arg) {
-    if (name == "sin")  return sin(arg);
-    if (name == "cos")  return cos(arg);
-    if (name == "tan")  return tan(arg);
-    if (name == "log")  return log10(arg);
-    if (name == "ln")   return log(arg);
-    if (name == "sqrt") return sqrt(arg);
+int func2id(string_view name) {
+    for (int f = 0; f < N_FUNC; ++f)
+        if (name == funcName[f]) return f;
+    return -1;
+}
+
+double callFunc(int id, double arg) {
+    switch (id) {
+    case F_SIN:  return sin(arg);
+    case F_COS:  return cos(arg);
+    case F_TAN:  return tan(arg);
+    case F_LOG:  return log10(arg);
+    case F_LN:   return log(arg);
+    case F_SQRT: return sqrt(arg);
+    }
     throw "δ֪";
 }
 
-double evaluate(const string& expr) {
-    string src = preprocess(expr);
+/* ʷֱɨԭʼ룬߶ preprocess() Ĺ淶
+   հȫǿոȫתǣĩβΪ '#'ȫ̲ڴ */
+class Lexer {
+public:
+    explicit Lexer(string_view s) : src(s), pos(0), width(0), done(false) {}
+    char peek() {
+        while (pos < src.size()) {
+            unsigned char c = src[pos];
+            if (c == 0xe3 && pos + 2 < src.size() && (unsigned char)src[pos + 1] == 0x80) {
+                unsigned char c2 = src[pos + 2];
+                if (c2 == 0x80) { pos += 3; continue; }
+                if (c2 == 0x88) { width = 3; return '('; }
+                if (c2 == 0x89) { width = 3; return ')'; }
+            }
+            if (isspace(c)) { ++pos; continue; }
+            width = 1;
+            return c;
+        }
+        width = 0;
+        return '#';
+    }
+    void skip() {                       //  peek() صַ
+        if (width == 0) done = true;
+        pos += width;
+    }
+    bool finished() const { return done; }
+    double number() {                   // ǰλֻС
+        char buf[128];
+        int n = 0;
+        size_t begin = pos;
+        bool contiguous = true;         // мûбĿհʱֱԭϽ
+        for (char c = peek(); isdigit(c) || c == '.'; c = peek()) {
+            if (pos != begin + n) contiguous = false;
+            if (n < (int)sizeof(buf)) buf[n] = c;
+            ++n;
+            skip();
+        }
+        if (contiguous) return parse(src.data() + begin, src.data() + begin + n);
+        if (n <= (int)sizeof(buf)) return parse(buf, buf + n);
+        string big;                     // Һհ׵֣ټ
+        for (size_t i = begin; i < pos; ++i)
+            if (isdigit((unsigned char)src[i]) || src[i] == '.') big += src[i];
+        return parse(big.data(), big.data() + big.size());
+    }
+    int funcName() {                    // ǰλĸȷΪ '('
+        char buf[8];
+        int n = 0;
+        for (char c = peek(); isalpha((unsigned char)c); c = peek()) {
+            if (n < (int)sizeof(buf)) buf[n] = c;
+            ++n;
+            skip();
+        }
+        if (peek() != '(') throw " '('";
+        skip();
+        int f = n <= (int)sizeof(buf) ? func2id(string_view(buf, n)) : -1;
+        if (f < 0) throw "δ֪";
+        return f;
+    }
+private:
+    string_view src;
+    size_t pos, width;
+    bool done;
+
+    static double parse(const char* b, const char* e) {   //  strtod һ£ʱΪ 0Ϊ inf
+        double v = 0;
+        from_chars_result r = from_chars(b, e, v);
+        if (r.ec == errc::result_out_of_range) return HUGE_VAL;
+        return r.ec == errc() ? v : 0;
+    }
+};
+
+/* ʽֵɨ裬õһͬջƥʱ͵ֵ
+   ʽһֵڵ㲻ȡõǰջеĲ
+   ʱǡһֵ˼¼ÿÿʼʱĲջ */
+double evaluate(string_view expr) {
+    Lexer lx(expr);
     Stack<double> opnd;
     Stack<char>   optr;
+    Stack<int>    fn;       //  optr еÿ '(' ӦţͨΪ -1
+    Stack<int>    base;     // ÿ㺯ÿʼʱ opnd 
     optr.push('#');
+    base.push(0);
 
-    string s;
-    for (string::size_type i = 0; i < src.size(); ++i) s += src[i];
-    s += '#';
-
-    string::size_type i = 0;
-    while (i < s.size()) {
-        char c = s[i];
+    while (!lx.finished()) {
+        char c = lx.peek();
         if (isdigit(c) || c == '.') {
-            string numStr;
-            while (i < s.size() && (isdigit(s[i]) || s[i] == '.'))
-                numStr += s[i++];
-            opnd.push(str2double(numStr));
+            opnd.push(lx.number());
             continue;
         }
         /*  */
-        if (isalpha(c)) {
-            string fname;
-            while (i < s.size() && isalpha(s[i])) fname += s[i++];
-            if (s[i] != '(') throw  " '('";
-            ++i;
-            int dep = 1;
-            string sub;
-            while (i < s.size() && dep) {
-                if (s[i] == '(') ++dep;
-                else if (s[i] == ')') --dep;
-                if (dep) sub += s[i++];
-                else break;
-            }
-            if (dep) throw "Ųƥ";
-            ++i; // skip ')'
-            double arg = evaluate(sub);
-            opnd.push(callFunc(fname, arg));
+        if (isalpha((unsigned char)c)) {
+            fn.push(lx.funcName());
+            optr.push('(');
+            base.push(opnd.size());
             continue;
         }
         /*  */
@@ -180,19 +312,31 @@ double evaluate(const string& expr) {
             /* ˳ */
             if (topOp == '#' && c == '#') {
                 optr.pop();
-                ++i;
+                lx.skip();
                 break;
             }
+            if (topOp == '(' && fn.peek() >= 0) throw "Ųƥ";
             throw "ȼ";
         }
         if (rel == 1) {          // <
             optr.push(c);
-            ++i;
+            if (c == '(') fn.push(-1);
+            lx.skip();
         } else if (rel == 2) {   // =
             optr.pop();
-            ++i;
+            if (c == ')') {
+                int f = fn.pop();
+                if (f >= 0) {
+                    int d = opnd.size() - base.pop();
+                    if (d != 1) throw d < 1 ? "ջ" : "ʽ쳣";
+                    opnd.push(callFunc(f, opnd.pop()));
+                }
+            }
+            lx.skip();
         } else {                 // >
             char theta = optr.pop();
+            if (opnd.size() < base.peek() + (theta == '!' ? 1 : 2)) throw "ջ";
+            if (theta == '!') { opnd.push(fact(opnd.pop())); continue; }
             double b = opnd.pop();
             double a = opnd.pop();
             opnd.push(calc(a, theta, b));
@@ -203,8 +347,1263 @@ double evaluate(const string& expr) {
     return ans;
 }
 
+/* ---------- ִУʽֻһΣɺ׺ָУ֮󷴸ֵ ---------- */
+enum OpCode { OP_CONST, OP_VAR, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_FAC, OP_FUNC };
+struct Instr {
+    unsigned char op;
+    int arg;              // OP_VAR±ꣻOP_FUNC
+    double val;           // OP_CONSTֵ
+};
+
+struct Program {
+    vector<Instr> code;
+    vector<string> vars;  // ±꼴ֵʱ vals[] еλ
+    int depth;            // ֵջ
+
+    Program() : depth(0) {}
+    int varIndex(const string& name) const {
+        for (size_t k = 0; k < vars.size(); ++k)
+            if (vars[k] == name) return (int)k;
+        return -1;
+    }
+    double eval(const double* vals = NULL) const;
+};
+
+/* ֵѭջ޷䡢޽ */
+double Program::eval(const double* vals) const {
+    if (!vars.empty() && !vals) throw "δ";
+    double buf[64];
+    vector<double> big;
+    double* st = buf;
+    if (depth > 64) { big.resize(depth); st = &big[0]; }
+    int top = -1;
+    for (size_t k = 0; k < code.size(); ++k) {
+        const Instr& in = code[k];
+        switch (in.op) {
+        case OP_CONST: st[++top] = in.val; break;
+        case OP_VAR:   st[++top] = vals[in.arg]; break;
+        case OP_ADD:   --top; st[top] += st[top + 1]; break;
+        case OP_SUB:   --top; st[top] -= st[top + 1]; break;
+        case OP_MUL:   --top; st[top] *= st[top + 1]; break;
+        case OP_DIV:
+            --top;
+            if (fabs(st[top + 1]) < 1e-12) throw "";
+            st[top] /= st[top + 1];
+            break;
+        case OP_POW:   --top; st[top] = pow(st[top], st[top + 1]); break;
+        case OP_FAC:   st[top] = fact(st[top]); break;
+        case OP_FUNC:  st[top] = callFunc(in.arg, st[top]); break;
+        }
+    }
+    return st[0];
+}
+
+/*  evaluate() ȼԼʱָǼ㣻
+   õһջƥʱ OP_FUNCݹؽ
+   ȫΪʱ͵۵ */
+class Compiler {
+public:
+    explicit Compiler(Program& p) : prog(p), cur(0) { base.push(0); }
+    void compile(const string& src);
+private:
+    Program& prog;
+    int cur;              // ǰģջ
+    Stack<int> base;      // ÿ㺯ÿʼʱջͬ evaluate()
+
+    void emitOperand(const Instr& in) {
+        prog.code.push_back(in);
+        if (++cur > prog.depth) prog.depth = cur;
+    }
+    bool constAt(size_t back) const {       //  back ָǷ
+        return prog.code.size() >= back && prog.code[prog.code.size() - back].op == OP_CONST;
+    }
+    void emitUnary(unsigned char op, int arg) {
+        if (cur < base.peek() + 1) throw "ջ";
+        if (constAt(1)) {
+            double& v = prog.code.back().val;
+            v = (op == OP_FAC) ? fact(v) : callFunc(arg, v);
+            return;
+        }
+        Instr in = { op, arg, 0 };
+        prog.code.push_back(in);
+    }
+    void emitBinary(char theta) {
+        if (cur < base.peek() + 2) throw "ջ";
+        --cur;
+        if (constAt(1) && constAt(2)) {
+            double b = prog.code.back().val;
+            prog.code.pop_back();
+            double& a = prog.code.back().val;
+            a = calc(a, theta, b);
+            return;
+        }
+        unsigned char op = OP_ADD;
+        switch (theta) {
+        case '+': op = OP_ADD; break;
+        case '-': op = OP_SUB; break;
+        case '*': op = OP_MUL; break;
+        case '/': op = OP_DIV; break;
+        case '^': op = OP_POW; break;
+        default: throw "Ƿ˫Ŀ";
+        }
+        Instr in = { op, 0, 0 };
+        prog.code.push_back(in);
+    }
+};
+
+void Compiler::compile(const string& src) {
+    string s = src + '#';
+    Stack<char> optr;
+    Stack<int>  fn;       //  optr еÿ '(' ӦţͨΪ -1
+    optr.push('#');
+    string::size_type i = 0;
+    while (i < s.size()) {
+        char c = s[i];
+        if (isdigit(c) || c == '.') {
+            string::size_type j = i;
+            while (j < s.size() && (isdigit(s[j]) || s[j] == '.')) ++j;
+            Instr in = { OP_CONST, 0, str2double(s.substr(i, j - i)) };
+            emitOperand(in);
+            i = j;
+            continue;
+        }
+        if (isalpha(c)) {
+            string::size_type j = i;
+            while (j < s.size() && isalpha(s[j])) ++j;
+            string name = s.substr(i, j - i);
+            i = j;
+            if (s[i] == '(') {            // 
+                int f = func2id(name);
+                if (f < 0) throw "δ֪";
+                optr.push('(');
+                fn.push(f);
+                base.push(cur);
+                ++i;
+            } else {                      // 
+                int v = prog.varIndex(name);
+                if (v < 0) { v = (int)prog.vars.size(); prog.vars.push_back(name); }
+                Instr in = { OP_VAR, v, 0 };
+                emitOperand(in);
+            }
+            continue;
+        }
+        char topOp = optr.peek();
+        int idx1 = op2idx(topOp), idx2 = op2idx(c);
+        if (idx1 < 0 || idx2 < 0) throw "Ƿ";
+        int rel = relOp(pri[idx1][idx2]);
+        if (rel == 0) {
+            if (topOp == '#' && c == '#') { optr.pop(); ++i; break; }
+            if (topOp == '(' && fn.peek() >= 0) throw "Ųƥ";
+            throw "ȼ";
+        }
+        if (rel == 1) {          // <
+            optr.push(c);
+            if (c == '(') fn.push(-1);
+            ++i;
+        } else if (rel == 2) {   // =
+            optr.pop();
+            if (c == ')') {
+                int f = fn.pop();
+                if (f >= 0) {
+                    int d = cur - base.pop();
+                    if (d != 1) throw d < 1 ? "ջ" : "ʽ쳣";
+                    emitUnary(OP_FUNC, f);
+                }
+            }
+            ++i;
+        } else {                 // >
+            char theta = optr.pop();
+            if (theta == '!') emitUnary(OP_FAC, 0);
+            else emitBinary(theta);
+        }
+    }
+    if (cur < 1) throw "ջ";
+    if (cur != 1 || !optr.empty()) throw "ʽ쳣";
+}
+
+Program compile(const string& expr) {
+    Program p;
+    Compiler(p).compile(preprocess(expr));
+    return p;
+}
+
+/* ---------- ʽֵͬһʽڶ ---------- */
+/* ѧˣ y[i] = f(x[i]) ޷֧ѭ-O3 ɱ SIMD 룻
+   ·Ԫأ˵ڵڶ libm  x  y ص
+   ȣ main ʵӡ
+     vsin/vcos/vtan  |x| <= 1e5Cody-Waite  /2 Լ + fdlibm ʽ
+                     sin/cos  < 1e-15tan ڼ㸽޽磬İƣ< 1e-15ӽ double
+     vln/vlog        atanh  < 1e-150infnan  libm
+     vsqrt           ֱ sqrtӲָȷ */
+static const double TRIG_FAST_MAX = 1e5;
+
+static inline unsigned long long dbits(double x) { unsigned long long u; memcpy(&u, &x, 8); return u; }
+static inline double bitsd(unsigned long long u) { double x; memcpy(&x, &u, 8); return x; }
+
+/* Լ [-/4, /4]q Ϊޣsncs Ϊ r ҡ */
+static inline void sincosKernel(double x, double& sn, double& cs, int& q) {
+    const double TWO_OVER_PI = 6.36619772367581382433e-01;
+    const double P1 = 1.57079632673412561417e+00, P2 = 6.07710050630396597660e-11,
+                 P3 = 2.02226624879595063154e-21;
+    const double MAGIC = 6755399441055744.0;        // 1.5 * 2^52ϺλΪȡ
+    double y = x * TWO_OVER_PI + MAGIC;
+    q = (int)(dbits(y) & 3);
+    double k = y - MAGIC;
+    double r = ((x - k * P1) - k * P2) - k * P3;
+    double z = r * r;
+    sn = r + r * z * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03
+         + z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06
+         + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+    cs = 1.0 - 0.5 * z + z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03
+         + z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07
+         + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+}
+
+/* ѡȡ sn/cs תţλ֧ */
+static inline double quadSelect(double sn, double cs, int useCos, int neg) {
+    unsigned long long mask = 0ULL - (unsigned long long)useCos;
+    return bitsd(((dbits(sn) & ~mask) | (dbits(cs) & mask)) ^ ((unsigned long long)neg << 63));
+}
+
+void vsin(const double* __restrict x, double* __restrict y, int n) {
+    for (int i = 0; i < n; ++i) {
+        double sn, cs; int q;
+        sincosKernel(x[i], sn, cs, q);
+        y[i] = quadSelect(sn, cs, q & 1, (q >> 1) & 1);
+    }
+    for (int i = 0; i < n; ++i) if (!(fabs(x[i]) <= TRIG_FAST_MAX)) y[i] = sin(x[i]);
+}
+void vcos(const double* __restrict x, double* __restrict y, int n) {
+    for (int i = 0; i < n; ++i) {
+        double sn, cs; int q;
+        sincosKernel(x[i], sn, cs, q);
+        y[i] = quadSelect(cs, sn, q & 1, ((q + 1) >> 1) & 1);
+    }
+    for (int i = 0; i < n; ++i) if (!(fabs(x[i]) <= TRIG_FAST_MAX)) y[i] = cos(x[i]);
+}
+void vtan(const double* __restrict x, double* __restrict y, int n) {
+    for (int i = 0; i < n; ++i) {
+        double sn, cs; int q;
+        sincosKernel(x[i], sn, cs, q);
+        double num = quadSelect(sn, cs, q & 1, q & 1);      //  tan = -cs / sn
+        double den = quadSelect(cs, sn, q & 1, 0);
+        y[i] = num / den;
+    }
+    for (int i = 0; i < n; ++i) if (!(fabs(x[i]) <= TRIG_FAST_MAX)) y[i] = tan(x[i]);
+}
+void vln(const double* __restrict x, double* __restrict y, int n) {
+    const double LN2_HI = 6.93147180369123816490e-01, LN2_LO = 1.90821492927058770002e-10;
+    for (int i = 0; i < n; ++i) {
+        unsigned long long u = dbits(x[i]);
+        double m = bitsd((u & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);    // [1, 2)
+        double e = bitsd(0x4330000000000000ULL | ((u >> 52) & 0x7ff)) - 4503599627370496.0;  // ָת
+        int hw = (int)(u >> 32) & 0xfffff;                      // β 20 λ 2 Ƚϣ۰ʹ m  [2/2, 2]
+        double hi = (double)((unsigned)(0x6a09e - hw) >> 31);    // ȡλȽϣ
+        m = m * (1.0 - 0.5 * hi);
+        double k = e - 1023 + hi;
+        double s = (m - 1.0) / (m + 1.0), z = s * s;
+        double t = z * (1.0 / 3 + z * (1.0 / 5 + z * (1.0 / 7 + z * (1.0 / 9 + z * (1.0 / 11
+                 + z * (1.0 / 13 + z * (1.0 / 15 + z * (1.0 / 17 + z * (1.0 / 19)))))))));
+        y[i] = k * LN2_HI + (2 * s + (2 * s * t + k * LN2_LO));
+    }
+    for (int i = 0; i < n; ++i)
+        if (!(x[i] >= 2.2250738585072014e-308 && x[i] <= 1.7976931348623157e308)) y[i] = log(x[i]);
+}
+void vlog(const double* __restrict x, double* __restrict y, int n) {
+    vln(x, y, n);
+    for (int i = 0; i < n; ++i) y[i] *= 0.43429448190325182765;      // 1 / ln10
+}
+void vsqrt(const double* __restrict x, double* __restrict y, int n) {
+    for (int i = 0; i < n; ++i) y[i] = sqrt(x[i]);
+}
+
+void callFuncBatch(int id, const double* x, double* y, int n) {
+    switch (id) {
+    case F_SIN:  vsin(x, y, n); return;
+    case F_COS:  vcos(x, y, n); return;
+    case F_TAN:  vtan(x, y, n); return;
+    case F_LOG:  vlog(x, y, n); return;
+    case F_LN:   vln(x, y, n); return;
+    case F_SQRT: vsqrt(x, y, n); return;
+    }
+    throw "δ֪";
+}
+
+/* д룺evaluate() ׳Ĵģʽ°м¼ӦΪ NaN */
+enum RowError { ROW_OK = 0, ROW_DIV0, ROW_FACT };
+const char* rowErrorText[] = { "", "", "׳˲Ƿ" };
+
+/* cols[k] Ϊ p.vars[k] У BLK һ顢ִָ */
+void evalBatch(const Program& p, const double* const* cols, size_t nRows, double* out, unsigned char* err) {
+    const int BLK = 256;
+    vector<double> stk((size_t)max(p.depth, 1) * BLK);
+    unsigned char em[BLK];
+    double tmp[BLK];
+    for (size_t r0 = 0; r0 < nRows; r0 += BLK) {
+        int m = (int)min((size_t)BLK, nRows - r0);
+        memset(em, 0, m);
+        int top = -1;
+        for (size_t k = 0; k < p.code.size(); ++k) {
+            const Instr& in = p.code[k];
+            if (in.op == OP_CONST || in.op == OP_VAR) ++top;
+            else if (in.op != OP_FAC && in.op != OP_FUNC) --top;
+            double* a = &stk[(size_t)top * BLK];      // 
+            double* b = a + BLK;                      // ˫ĿҲ
+            switch (in.op) {
+            case OP_CONST: for (int i = 0; i < m; ++i) a[i] = in.val; break;
+            case OP_VAR:   memcpy(a, cols[in.arg] + r0, m * sizeof(double)); break;
+            case OP_ADD: for (int i = 0; i < m; ++i) a[i] += b[i]; break;
+            case OP_SUB: for (int i = 0; i < m; ++i) a[i] -= b[i]; break;
+            case OP_MUL: for (int i = 0; i < m; ++i) a[i] *= b[i]; break;
+            case OP_DIV:
+                for (int i = 0; i < m; ++i) {
+                    bool z = fabs(b[i]) < 1e-12;
+                    em[i] = (z && !em[i]) ? (unsigned char)ROW_DIV0 : em[i];
+                    a[i] /= b[i];
+                }
+                break;
+            case OP_POW: for (int i = 0; i < m; ++i) a[i] = pow(a[i], b[i]); break;
+            case OP_FAC:
+                for (int i = 0; i < m; ++i) {
+                    if (a[i] < 0 || a[i] != floor(a[i])) { if (!em[i]) em[i] = ROW_FACT; a[i] = NAN; }
+                    else a[i] = tgamma(a[i] + 1);
+                }
+                break;
+            case OP_FUNC:
+                callFuncBatch(in.arg, a, tmp, m);
+                memcpy(a, tmp, m * sizeof(double));
+                break;
+            }
+        }
+        for (int i = 0; i < m; ++i) {
+            out[r0 + i] = em[i] ? NAN : stk[i];
+            if (err) err[r0 + i] = em[i];
+        }
+    }
+}
+
+/* Уnames[k] Ӧ cols[k] */
+void evalBatch(const string& expr, const vector<string>& names, const vector<const double*>& cols,
+               size_t nRows, double* out, unsigned char* err) {
+    Program p = compile(expr);
+    vector<const double*> bound(p.vars.size());
+    for (size_t v = 0; v < p.vars.size(); ++v) {
+        size_t k = find(names.begin(), names.end(), p.vars[v]) - names.begin();
+        if (k == names.size()) throw "δ";
+        bound[v] = cols[k];
+    }
+    evalBatch(p, bound.empty() ? NULL : &bound[0], nRows, out, err);
+}
+
+/* ѹʽеı滻Ϊֵıִ·ʹ */
+string substVar(const string& f, const string& var, double v) {
+    char num[64];
+    snprintf(num, sizeof(num), "%.6f", v);
+    string out;
+    for (string::size_type i = 0; i < f.size(); ) {
+        if (isalpha(f[i])) {
+            string::size_type j = i;
+            while (j < f.size() && isalpha(f[j])) ++j;
+            out += (f.compare(i, j - i, var) == 0) ? string(num) : f.substr(i, j - i);
+            i = j;
+        } else out += f[i++];
+    }
+    return out;
+}
+
+double nowNs() {
+    return (double)chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* evaluate() ÿεõĺʱCOUNT_ALLOC Թѷ */
+void benchEvaluate(const char* const* exprs, int n, int rounds) {
+    for (int i = 0; i < n; ++i) {
+        double sum = 0;
+#ifdef COUNT_ALLOC
+        size_t a0 = g_allocCount.load();
+#endif
+        double t0 = nowNs();
+        try {
+            for (int r = 0; r < rounds; ++r) sum += evaluate(exprs[i]);
+        } catch (const char*) { continue; }
+        double t1 = nowNs();
+#ifdef COUNT_ALLOC
+        size_t allocs = g_allocCount.load() - a0;
+        printf("  %-28s %7.1f ns/Σ %.2f /\n", exprs[i], (t1 - t0) / rounds, (double)allocs / rounds);
+#else
+        printf("  %-28s %7.1f ns/\n", exprs[i], (t1 - t0) / rounds);
+#endif
+    }
+}
+
+/* ִ vs ִУͬһʽͬ x */
+void benchCompiled(const string& formula, int rounds) {
+    const int NX = 1000;
+    vector<string> texts(NX);
+    vector<double> xs(NX);
+    for (int k = 0; k < NX; ++k) {
+        xs[k] = 1.5 + k * 0.25;
+        texts[k] = substVar(formula, "x", xs[k]);
+    }
+    double sum1 = 0, sum2 = 0;
+    double t0 = nowNs();
+    for (int r = 0; r < rounds; ++r) sum1 += evaluate(texts[r % NX]);
+    double t1 = nowNs();
+    Program p = compile(formula);
+    double t2 = nowNs();
+    for (int r = 0; r < rounds; ++r) sum2 += p.eval(&xs[r % NX]);
+    double t3 = nowNs();
+    printf("%s\n  ָ %d %.0f ns %.1f ns/Σ %.1f ns/Σ%s\n",
+           formula.c_str(), (int)p.code.size(), t2 - t1, (t1 - t0) / rounds, (t3 - t2) / rounds,
+           fabs(sum1 - sum2) <= 1e-6 * fabs(sum1) ? "һ" : "һ");
+}
+
+/* ѧ libm tan һȡӽ (k+1/2)  double */
+void checkKernels() {
+    const int NK = 200000;
+    const long double PI_L = 3.141592653589793238462643383279502884L;
+    vector<double> x(NK), y(NK);
+    void (*vk[])(const double*, double*, int) = { vsin, vcos, vtan, vlog, vln, vsqrt };
+    double lo[] = { -1e5, -1e5, -1e5, 1e-300, 1e-300, 0 };
+    double hi[] = {  1e5,  1e5,  1e5, 1e300, 1e300, 1e6 };
+    for (int f = 0; f < N_FUNC; ++f) {
+        for (int i = 0; i < NK; ++i) {
+            double t = (double)i / (NK - 1);
+            x[i] = (f == F_LOG || f == F_LN) ? exp(log(lo[f]) + t * (log(hi[f]) - log(lo[f]))) : lo[f] + t * (hi[f] - lo[f]);
+            if (f == F_TAN && (i & 1)) x[i] = (double)((floorl(x[i] / PI_L) + 0.5L) * PI_L);
+        }
+        vk[f](&x[0], &y[0], NK);
+        double worst = 0;
+        for (int i = 0; i < NK; ++i) {
+            double ref = callFunc(f, x[i]);
+            double e = fabs(y[i] - ref) / (f == F_TAN ? fabs(ref) : max(1.0, fabs(ref)));
+            worst = max(worst, e);
+        }
+        printf("  %-5s  %.2e %s\n", funcName[f], worst, f == F_TAN ? "|f|" : "max(1,|f|)");
+    }
+}
+
+/*  evaluate() /  Program::eval() / ʽ evalBatch() */
+void benchBatch(size_t rows) {
+    const char* f = "sin(x) * cos(y) + sqrt(x) * ln(y) / (y - 2)";
+    vector<double> xs(rows), ys(rows), o1(rows), o2(rows);
+    vector<unsigned char> err(rows);
+    for (size_t r = 0; r < rows; ++r) { xs[r] = 0.5 + r % 1000 * 0.01; ys[r] = 1 + r % 9 * 0.125; }
+    size_t slow = min(rows, (size_t)20000);
+    double t0 = nowNs();
+    for (size_t r = 0; r < slow; ++r) {
+        try { evaluate(substVar(substVar(f, "x", xs[r]), "y", ys[r])); } catch (const char*) {}
+    }
+    double t1 = nowNs();
+    Program p = compile(f);
+    double xy[2];
+    for (size_t r = 0; r < rows; ++r) {
+        xy[p.varIndex("x")] = xs[r]; xy[p.varIndex("y")] = ys[r];
+        try { o1[r] = p.eval(xy); } catch (const char*) { o1[r] = NAN; }
+    }
+    double t2 = nowNs();
+    vector<string> names; names.push_back("x"); names.push_back("y");
+    vector<const double*> cols; cols.push_back(&xs[0]); cols.push_back(&ys[0]);
+    evalBatch(f, names, cols, rows, &o2[0], &err[0]);
+    double t3 = nowNs();
+    double diff = 0;
+    size_t bad = 0;
+    for (size_t r = 0; r < rows; ++r) {
+        if (err[r]) { bad += (err[r] == ROW_DIV0 && isnan(o1[r])); continue; }
+        diff = max(diff, fabs(o1[r] - o2[r]));
+    }
+    size_t nerr = rows - count(err.begin(), err.end(), (unsigned char)ROW_OK);
+    printf("%s, %zu \n  evaluate %.1f ns/Уeval %.1f ns/УevalBatch %.1f ns/У %.2e %zuһ %zu\n",
+           f, rows, (t1 - t0) / slow, (t2 - t1) / rows, (t3 - t2) / rows, diff, nerr, bad);
+}
+
+/* ---------- 棺 preprocess() 淶ıΪLRU ̭̰߳ȫ ---------- */
+class ProgramCache {
+public:
+    typedef shared_ptr<const Program> Ptr;
+    explicit ProgramCache(size_t cap = 1024) : cap(max(cap, (size_t)1)), hits(0), misses(0), evictions(0) {}
+
+    /* ֱӷѱδʱ룬̣߳ */
+    Ptr get(const string& expr) {
+        string key = preprocess(expr);
+        {
+            lock_guard<mutex> g(mu);
+            Map::iterator it = idx.find(key);
+            if (it != idx.end()) {
+                lru.splice(lru.begin(), lru, it->second);
+                ++hits;
+                return it->second->second;
+            }
+            ++misses;
+        }
+        Program p;
+        Compiler(p).compile(key);
+        Ptr prog = make_shared<const Program>(p);
+        lock_guard<mutex> g(mu);
+        Map::iterator it = idx.find(key);
+        if (it != idx.end()) return it->second->second;   // ߳Ȳ
+        lru.push_front(make_pair(key, prog));
+        idx[key] = lru.begin();
+        while (lru.size() > cap) {
+            idx.erase(lru.back().first);
+            lru.pop_back();
+            ++evictions;
+        }
+        return prog;
+    }
+    double eval(const string& expr, const double* vals = NULL) { return get(expr)->eval(vals); }
+
+    size_t size()      { lock_guard<mutex> g(mu); return lru.size(); }
+    size_t hitCount()  { lock_guard<mutex> g(mu); return hits; }
+    size_t missCount() { lock_guard<mutex> g(mu); return misses; }
+    size_t evictCount(){ lock_guard<mutex> g(mu); return evictions; }
+    double hitRate()   { lock_guard<mutex> g(mu); return hits + misses ? (double)hits / (hits + misses) : 0; }
+private:
+    typedef list< pair<string, Ptr> > List;
+    typedef unordered_map<string, List::iterator> Map;
+    size_t cap;
+    mutex mu;
+    List lru;             // ͷʹ
+    Map idx;
+    size_t hits, misses, evictions;
+};
+
+/* ---------- ڱʽ̶ʽڱʱȫ۵ĹʽչΪֱߴ ---------- */
+namespace ce {
+
+/* ۵õ constexpr ѧ׼ sin/log Ȳ constexpr
+   ʮƳ sqrt ϸȷ룻ln/log/exp/pow/sin/cos/tan ˫ȣdouble-doubleԼ 106 λ
+   һΣֵ double е㣬ȷֵ
+    evaluate()from_chars + libmĹϵ㡢sqrtλһ£
+   ln/log//Ǻȡ libm Ƿȷ롪glibc  log10 Լ 1.6% Ĳ
+   pow/sin/tan Լ 0.1%~0.2% Ĳȷֵ 1 ulpʱ 1 ulpcheckConstFold() ˶ */
+constexpr double NaN = numeric_limits<double>::quiet_NaN();
+constexpr double INF = numeric_limits<double>::infinity();
+constexpr double PI_2_1 = 1.57079632673412561417e+00, PI_2_2 = 6.07710050630396597660e-11,
+                 PI_2_3 = 2.02226624879595063154e-21, PI_2_4 = 8.47842766036889956997e-32;   // /2 Ķβ
+
+constexpr double fabs_(double x) { return x < 0 ? -x : x; }
+constexpr double ldexp_(double x, int e) {       // x * 2^eγ˳ 2ɱʾʱ
+    for (; e > 0; --e) x *= 2;
+    for (; e < 0; ++e) x /= 2;
+    return x;
+}
+
+/* ˫ hi + lohi Ϊ͵ֵlo Ϊ */
+struct DD { double hi, lo; };
+constexpr DD twoSum(double a, double b) {
+    double s = a + b, bb = s - a;
+    return DD{ s, (a - (s - bb)) + (b - bb) };
+}
+constexpr DD fastTwoSum(double a, double b) {   // Ҫ |a| >= |b|
+    double s = a + b;
+    return DD{ s, b - (s - a) };
+}
+constexpr DD twoProd(double a, double b) {      // Dekker ֣ fma Ҳõȷ˻
+    double p = a * b;
+    if (p == 0 || fabs_(p) > 1e300) return DD{ p, 0 };
+    const double SPLIT = 134217729.0;            // 2^27 + 1
+    double ta = SPLIT * a, ah = ta - (ta - a), al = a - ah;
+    double tb = SPLIT * b, bh = tb - (tb - b), bl = b - bh;
+    return DD{ p, ((ah * bh - p) + ah * bl + al * bh) + al * bl };
+}
+constexpr DD ddNeg(DD a) { return DD{ -a.hi, -a.lo }; }
+constexpr DD ddAdd(DD a, DD b) {
+    DD s = twoSum(a.hi, b.hi), t = twoSum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = fastTwoSum(s.hi, s.lo);
+    s.lo += t.lo;
+    return fastTwoSum(s.hi, s.lo);
+}
+constexpr DD ddMul(DD a, DD b) {
+    DD p = twoProd(a.hi, b.hi);
+    if (fabs_(p.hi) == INF) return DD{ p.hi, 0 };
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return fastTwoSum(p.hi, p.lo);
+}
+constexpr DD ddDiv(DD a, DD b) {                // ĳ
+    double q1 = a.hi / b.hi;
+    if (fabs_(q1) == INF || q1 == 0) return DD{ q1, 0 };
+    DD r = ddAdd(a, ddNeg(ddMul(b, DD{ q1, 0 })));
+    double q2 = r.hi / b.hi;
+    r = ddAdd(r, ddNeg(ddMul(b, DD{ q2, 0 })));
+    double q3 = r.hi / b.hi;
+    return ddAdd(fastTwoSum(q1, q2), DD{ q3, 0 });
+}
+constexpr double ddRound(DD a) { return a.hi + a.lo; }
+
+constexpr DD LN2 = { 0.6931471805599453, 2.3190468138462996e-17 };
+constexpr DD LN10 = { 2.302585092994046, -2.1707562233822494e-16 };
+
+/* ln x = kln2 + 2atanh(s)s = (m - 1) / (m + 1)m  [2/2, 2)x Ϊ */
+constexpr DD lnDD(double x) {
+    int k = 0;
+    while (x >= 2) { x /= 2; ++k; }
+    while (x < 1) { x *= 2; --k; }
+    if (x > 1.41421356237309504880) { x /= 2; ++k; }
+    DD s = ddDiv(DD{ x - 1, 0 }, twoSum(x, 1));  // x - 1 ȷx + 1  twoSum 
+    DD z = ddMul(s, s), term = s, sum = s;
+    for (int n = 3; n < 200 && s.hi != 0; n += 2) {
+        term = ddMul(term, z);
+        DD t = ddDiv(term, DD{ (double)n, 0 });
+        sum = ddAdd(sum, t);
+        if (fabs_(t.hi) < 1e-34 * fabs_(sum.hi)) break;
+    }
+    return ddAdd(ddMul(DD{ (double)k, 0 }, LN2), ddAdd(sum, sum));
+}
+/* e^y = 2^k  e^rr = y - kln2|r| <= ln2 / 2֤߱ */
+constexpr DD expDD(DD y) {
+    long long k = (long long)(y.hi / LN2.hi + (y.hi >= 0 ? 0.5 : -0.5));
+    DD r = ddAdd(y, ddNeg(ddMul(DD{ (double)k, 0 }, LN2)));
+    DD term = { 1, 0 }, sum = { 1, 0 };
+    for (int n = 1; n < 40; ++n) {
+        term = ddDiv(ddMul(term, r), DD{ (double)n, 0 });
+        sum = ddAdd(sum, term);
+    }
+    return DD{ ldexp_(sum.hi, (int)k), ldexp_(sum.lo, (int)k) };
+}
+/* Լ [-/4, /4]q(/2) ÿγ˻ twoProd ȷ۳ */
+constexpr void sincosDD(double x, DD& sn, DD& cs) {
+    if (fabs_(x) > 1e15) throw "Ǻ޷ڱ۵";
+    long long q = (long long)(x / PI_2_1 + (x >= 0 ? 0.5 : -0.5));
+    double qd = (double)q;
+    DD r = ddAdd(DD{ x, 0 }, ddNeg(twoProd(qd, PI_2_1)));
+    r = ddAdd(r, ddNeg(twoProd(qd, PI_2_2)));
+    r = ddAdd(r, ddNeg(twoProd(qd, PI_2_3)));
+    r = ddAdd(r, ddNeg(twoProd(qd, PI_2_4)));
+    DD z = ddNeg(ddMul(r, r)), ts = r, tc = { 1, 0 }, s = r, c = { 1, 0 };
+    for (int n = 1; n < 25; ++n) {
+        ts = ddDiv(ddMul(ts, z), DD{ (double)((2 * n) * (2 * n + 1)), 0 }); s = ddAdd(s, ts);
+        tc = ddDiv(ddMul(tc, z), DD{ (double)((2 * n - 1) * (2 * n)), 0 }); c = ddAdd(c, tc);
+    }
+    int m = (int)(((q % 4) + 4) % 4);
+    sn = m == 0 ? s : m == 1 ? c : m == 2 ? ddNeg(s) : ddNeg(c);
+    cs = m == 0 ? c : m == 1 ? ddNeg(s) : m == 2 ? ddNeg(c) : s;
+}
+
+/* ȷƽx = m2^em  [1, 4)e Ϊż m2^104 Ϊ
+    128 λƽٰ Y  r*r + r ĴСͽ */
+constexpr double sqrt_(double x) {
+    if (x < 0 || x != x) return NaN;
+    if (x == 0 || x == INF) return x;
+    int e = 0;
+    while (x >= 4) { x /= 4; e += 2; }
+    while (x < 1) { x *= 4; e -= 2; }
+    unsigned __int128 Y = (unsigned __int128)(unsigned long long)(x * 4503599627370496.0) << 52;
+    double g = (1 + x) / 2;                      // Newton ƣ½
+    for (int i = 0; i < 100; ++i) {
+        double h = 0.5 * (g + x / g);
+        if (h >= g) break;
+        g = h;
+    }
+    unsigned long long r = (unsigned long long)(g * 4503599627370496.0);
+    while ((unsigned __int128)r * r > Y) --r;
+    while ((unsigned __int128)(r + 1) * (r + 1) <= Y) ++r;
+    if (Y - (unsigned __int128)r * r > r) ++r;     // sqrt(Y) > r + 1/2
+    return ldexp_((double)r, e / 2 - 52);
+}
+constexpr double ln_(double x) {
+    if (x < 0 || x != x) return NaN;
+    if (x == 0) return -INF;
+    if (x == INF) return INF;
+    return ddRound(lnDD(x));
+}
+constexpr double log10_(double x) {
+    if (x < 0 || x != x) return NaN;
+    if (x == 0) return -INF;
+    if (x == INF) return INF;
+    return ddRound(ddDiv(lnDD(x), LN10));
+}
+constexpr double pow_(double a, double b) {
+    if (b == 0) return 1;
+    if (a != a || b != b) return NaN;
+    if (fabs_(b) < 1e9 && b == (long long)b) {    // ݣ˫·ƽ
+        long long e = (long long)(b < 0 ? -b : b);
+        DD r = { 1, 0 }, t = { a, 0 };
+        for (; e; e >>= 1, t = ddMul(t, t)) if (e & 1) r = ddMul(r, t);
+        return ddRound(b < 0 ? ddDiv(DD{ 1, 0 }, r) : r);
+    }
+    if (a < 0) return NaN;
+    if (a == 0) return b > 0 ? 0 : INF;
+    if (a == INF) return b > 0 ? INF : 0;
+    DD y = ddMul(DD{ b, 0 }, lnDD(a));
+    if (y.hi > 709.8) return INF;
+    if (y.hi < -745.2) return 0;
+    return ddRound(expDD(y));
+}
+constexpr double func(int id, double x) {
+    DD sn = { 0, 0 }, cs = { 0, 0 };
+    if ((id == F_SIN || id == F_COS || id == F_TAN) && !(fabs_(x) < INF)) return NaN;
+    switch (id) {
+    case F_SIN:  sincosDD(x, sn, cs); return ddRound(sn);
+    case F_COS:  sincosDD(x, sn, cs); return ddRound(cs);
+    case F_TAN:  sincosDD(x, sn, cs); return ddRound(ddDiv(sn, cs));
+    case F_LOG:  return log10_(x);
+    case F_LN:   return ln_(x);
+    case F_SQRT: return sqrt_(x);
+    }
+    throw "δ֪";
+}
+
+/* ʮƳȷ루 from_chars/strtod һ£
+   β 2^53 Сλ 22 ʱ 10^k ȷɱʾһγȷ룻
+   ڴ 55~56 λ̣ͽż룬ʣྫ */
+struct Big {
+    static const int LIMBS = 80;                 // 2560 λԼ 770 λʮ
+    unsigned w[LIMBS] = {};
+    int n = 0;                                   // Ч
+    constexpr void mulAdd(unsigned m, unsigned a) {
+        unsigned long long carry = a;
+        for (int k = 0; k < n; ++k) {
+            carry += (unsigned long long)w[k] * m;
+            w[k] = (unsigned)carry;
+            carry >>= 32;
+        }
+        if (carry) {
+            if (n == LIMBS) throw "";
+            w[n++] = (unsigned)carry;
+        }
+    }
+    constexpr int bits() const { return n ? 32 * (n - 1) + 32 - __builtin_clz(w[n - 1]) : 0; }
+    constexpr void shl(int k) {
+        if (!n || !k) return;
+        if (bits() + k > 32 * LIMBS) throw "";
+        int ws = k / 32, bs = k % 32;
+        int m = (bits() + k + 31) / 32;
+        for (int i = m - 1; i >= 0; --i) {
+            unsigned long long hi = i - ws < n && i - ws >= 0 ? w[i - ws] : 0;
+            unsigned long long lo = bs && i - ws - 1 >= 0 && i - ws - 1 < n ? w[i - ws - 1] : 0;
+            w[i] = (unsigned)((hi << bs) | (bs ? lo >> (32 - bs) : 0));
+        }
+        n = m;
+    }
+    constexpr int cmp(const Big& o) const {
+        if (n != o.n) return n < o.n ? -1 : 1;
+        for (int k = n - 1; k >= 0; --k)
+            if (w[k] != o.w[k]) return w[k] < o.w[k] ? -1 : 1;
+        return 0;
+    }
+    constexpr void sub(const Big& o) {           // Ҫ *this >= o
+        long long borrow = 0;
+        for (int k = 0; k < n; ++k) {
+            long long d = (long long)w[k] - (k < o.n ? o.w[k] : 0) - borrow;
+            borrow = d < 0;
+            w[k] = (unsigned)(d + (borrow << 32));
+        }
+        while (n && !w[n - 1]) --n;
+    }
+};
+constexpr double decimal(const Big& digits, unsigned long long m, bool exact, int frac) {
+    constexpr double P10[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    if (exact && frac <= 22) return (double)m / P10[frac];
+    if (digits.n == 0) return 0;
+    Big N = digits, M;
+    M.mulAdd(1, 1);
+    for (int k = 0; k < frac; ++k) M.mulAdd(10, 0);
+    int s = 55 - (N.bits() - M.bits());          // ʹ (2^54, 2^56)
+    if (s > 0) N.shl(s); else M.shl(-s);
+    unsigned long long q = 0;
+    for (int b = 56; b >= 0; --b) {
+        Big T = M;
+        T.shl(b);
+        if (N.cmp(T) >= 0) { N.sub(T); q |= 1ULL << b; }
+    }
+    int len = 64 - __builtin_clzll(q);
+    int E = len - 1 - s;                         // ֵ  [2^E, 2^(E+1))
+    if (E > 1023) return INF;
+    int p = E < -1022 ? 53 - (-1022 - E) : 53;   // ֻʣ p λ
+    if (p < 0) return 0;
+    int drop = len - p;
+    unsigned long long low = q & ((1ULL << drop) - 1), half = 1ULL << (drop - 1);
+    q >>= drop;
+    if (low > half || (low == half && (N.n != 0 || (q & 1)))) ++q;
+    return ldexp_((double)q, drop - s);
+}
+constexpr double fact(double a) {
+    if (!::factArg(a)) throw "׳˲Ƿ";
+    double r = 1;
+    for (int i = 2; i <= (int)a; ++i) r *= i;
+    return r;
+}
+
+/* ڳ򣺶飬 Program ָͬ */
+const int MAX_CODE = 128, MAX_DEPTH = 64, MAX_VARS = 8, MAX_NAME = 16;
+struct Instr { int op = OP_CONST; int arg = 0; double val = 0; };
+struct Prog {
+    Instr code[MAX_CODE] = {};
+    int n = 0, depth = 0, nvars = 0;
+    char vars[MAX_VARS][MAX_NAME] = {};
+    constexpr bool isConst() const { return n == 1 && code[0].op == OP_CONST; }
+    constexpr double value() const {             // ʽֵڿ
+        if (!isConst()) throw "ʽ";
+        return code[0].val;
+    }
+};
+
+constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+constexpr bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+constexpr bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+/*  preprocess() ĹȡһЧַհȫǿոȫתǣĩβΪ '#' */
+constexpr char peekc(const char* s, int len, int& i, int& w) {
+    while (i < len) {
+        unsigned char c = s[i];
+        if (c == 0xe3 && i + 2 < len && (unsigned char)s[i + 1] == 0x80) {
+            unsigned char c2 = s[i + 2];
+            if (c2 == 0x80) { i += 3; continue; }
+            if (c2 == 0x88) { w = 3; return '('; }
+            if (c2 == 0x89) { w = 3; return ')'; }
+        }
+        if (isSpace(c)) { ++i; continue; }
+        w = 1;
+        return s[i];
+    }
+    w = 0;
+    return '#';
+}
+
+constexpr double calc(double a, char op, double b) {
+    switch (op) {
+    case '+': return a + b;
+    case '-': return a - b;
+    case '*': return a * b;
+    case '/':
+        if (fabs_(b) < 1e-12) throw "";
+        return a / b;
+    case '^': return pow_(a, b);
+    }
+    throw "Ƿ˫Ŀ";
+}
+
+/*  Compiler::compile ͬ㷨ֱʹ pri  op2idx/relOpڱɲ۵ָ */
+struct Builder {
+    Prog p;
+    int cur = 0;
+    int base[MAX_DEPTH] = {}, nb = 1;
+
+    constexpr void operand(Instr in) {
+        if (p.n >= MAX_CODE) throw "ʽ";
+        p.code[p.n++] = in;
+        if (++cur > p.depth) p.depth = cur;
+        if (cur > MAX_DEPTH) throw "ʽ";
+    }
+    constexpr void unary(int op, int arg) {
+        if (cur < base[nb - 1] + 1) throw "ջ";
+        Instr& last = p.code[p.n - 1];
+        if (last.op == OP_CONST) { last.val = (op == OP_FAC) ? fact(last.val) : func(arg, last.val); return; }
+        if (p.n >= MAX_CODE) throw "ʽ";
+        p.code[p.n++] = Instr{ op, arg, 0 };
+    }
+    constexpr void binary(char theta) {
+        if (cur < base[nb - 1] + 2) throw "ջ";
+        --cur;
+        if (p.code[p.n - 1].op == OP_CONST && p.code[p.n - 2].op == OP_CONST) {
+            p.code[p.n - 2].val = calc(p.code[p.n - 2].val, theta, p.code[p.n - 1].val);
+            --p.n;
+            return;
+        }
+        int op = theta == '+' ? OP_ADD : theta == '-' ? OP_SUB : theta == '*' ? OP_MUL
+               : theta == '/' ? OP_DIV : theta == '^' ? OP_POW : -1;
+        if (op < 0) throw "Ƿ˫Ŀ";
+        if (p.n >= MAX_CODE) throw "ʽ";
+        p.code[p.n++] = Instr{ op, 0, 0 };
+    }
+};
+
+constexpr Prog compile(const char* s) {
+    int len = 0;
+    while (s[len]) ++len;
+    Builder b;
+    char optr[MAX_DEPTH] = { '#' };
+    int fn[MAX_DEPTH] = {}, no = 1, nf = 0;
+    int i = 0, w = 0;
+    bool done = false;
+    while (!done) {
+        char c = peekc(s, len, i, w);
+        if (isDigit(c) || c == '.') {           //  from_chars ͬȷ
+            Big digits;
+            unsigned long long m = 0;
+            bool exact = true, dot = false;
+            int frac = 0;
+            for (; isDigit(c) || (c == '.' && !dot); c = peekc(s, len, i, w)) {
+                if (c == '.') dot = true;
+                else {
+                    unsigned d = c - '0';
+                    digits.mulAdd(10, d);
+                    if (exact && m > ((1ULL << 53) - d) / 10) exact = false;
+                    else if (exact) m = m * 10 + d;
+                    if (dot) ++frac;
+                }
+                i += w;
+            }
+            while (isDigit(c) || c == '.') { i += w; c = peekc(s, len, i, w); }   // ڶС֮󱻺
+            b.operand(Instr{ OP_CONST, 0, decimal(digits, m, exact, frac) });
+            continue;
+        }
+        if (isAlpha(c)) {
+            char name[MAX_NAME] = {};
+            int n = 0;
+            for (; isAlpha(c); c = peekc(s, len, i, w)) {
+                if (n + 1 >= MAX_NAME) throw "ֹ";
+                name[n++] = c;
+                i += w;
+            }
+            if (c == '(') {
+                int f = -1;
+                for (int k = 0; k < N_FUNC; ++k) {
+                    const char* fnm = funcName[k];
+                    int j = 0;
+                    while (fnm[j] && fnm[j] == name[j]) ++j;
+                    if (!fnm[j] && !name[j]) f = k;
+                }
+                if (f < 0) throw "δ֪";
+                if (no >= MAX_DEPTH) throw "ʽ";
+                optr[no++] = '(';
+                fn[nf++] = f;
+                b.base[b.nb++] = b.cur;
+                i += w;
+            } else {
+                int v = -1;
+                for (int k = 0; k < b.p.nvars && v < 0; ++k) {
+                    int j = 0;
+                    while (name[j] && b.p.vars[k][j] == name[j]) ++j;
+                    if (!name[j] && !b.p.vars[k][j]) v = k;
+                }
+                if (v < 0) {
+                    if (b.p.nvars >= MAX_VARS) throw "";
+                    v = b.p.nvars++;
+                    for (int j = 0; j < n; ++j) b.p.vars[v][j] = name[j];
+                }
+                b.operand(Instr{ OP_VAR, v, 0 });
+            }
+            continue;
+        }
+        char topOp = optr[no - 1];
+        int idx1 = op2idx(topOp), idx2 = op2idx(c);
+        if (idx1 < 0 || idx2 < 0) throw "Ƿ";
+        int rel = relOp(pri[idx1][idx2]);
+        if (rel == 0) {
+            if (topOp == '(' && nf > 0 && fn[nf - 1] >= 0) throw "Ųƥ";
+            throw "ȼ";
+        }
+        if (rel == 1) {
+            if (no >= MAX_DEPTH) throw "ʽ";
+            optr[no++] = c;
+            if (c == '(') fn[nf++] = -1;
+            i += w;
+        } else if (rel == 2) {
+            --no;
+            if (c == ')') {
+                int f = fn[--nf];
+                if (f >= 0) {
+                    int d = b.cur - b.base[--b.nb];
+                    if (d != 1) throw d < 1 ? "ջ" : "ʽ쳣";
+                    b.unary(OP_FUNC, f);
+                }
+            }
+            if (w == 0) done = true;            // ĩβƥ
+            i += w;
+        } else {
+            char theta = optr[--no];
+            if (theta == '!') b.unary(OP_FAC, 0);
+            else b.binary(theta);
+        }
+    }
+    if (b.cur < 1) throw "ջ";
+    if (b.cur != 1 || no != 0) throw "ʽ쳣";
+    return b.p;
+}
+
+/* ָչK ΪָţTop Ϊǰջȫڱȷֱߴ */
+template <const Prog& P, int K = 0, int Top = -1>
+inline double run(double* st, const double* vals) {
+    if constexpr (K == P.n) {
+        return st[0];
+    } else {
+        constexpr Instr in = P.code[K];
+        if constexpr (in.op == OP_CONST) {
+            st[Top + 1] = in.val;
+            return run<P, K + 1, Top + 1>(st, vals);
+        } else if constexpr (in.op == OP_VAR) {
+            st[Top + 1] = vals[in.arg];
+            return run<P, K + 1, Top + 1>(st, vals);
+        } else if constexpr (in.op == OP_FAC || in.op == OP_FUNC) {
+            st[Top] = (in.op == OP_FAC) ? ::fact(st[Top]) : callFunc(in.arg, st[Top]);
+            return run<P, K + 1, Top>(st, vals);
+        } else {
+            double a = st[Top - 1], b = st[Top];
+            if constexpr (in.op == OP_ADD) st[Top - 1] = a + b;
+            else if constexpr (in.op == OP_SUB) st[Top - 1] = a - b;
+            else if constexpr (in.op == OP_MUL) st[Top - 1] = a * b;
+            else if constexpr (in.op == OP_DIV) {
+                if (fabs(b) < 1e-12) throw "";
+                st[Top - 1] = a / b;
+            } else st[Top - 1] = pow(a, b);
+            return run<P, K + 1, Top - 1>(st, vals);
+        }
+    }
+}
+
+/* ڹʽ״γֵ˳󶨣 Program::eval ͬ */
+template <const Prog& P>
+inline double eval(const double* vals = NULL) {
+    if constexpr (P.isConst()) {
+        return P.code[0].val;
+    } else {
+        double st[P.depth];
+        return run<P>(st, vals);
+    }
+}
+
+}  // namespace ce
+
+/* ---------- ģʽļ룬ֵָ̳߳˳ ---------- */
+/* нı뽻ģʽֽһ£cout Ĭϸʽ %g
+   ҽģʽ " = " ֵʱǰ׺ԱֻӰ챾 */
+void formatLine(string_view line, string& out) {
+    char buf[64];
+    out += " = ";
+    try {
+        snprintf(buf, sizeof(buf), "%g", evaluate(line));
+        out += buf;
+    } catch (const char* e) {
+        out += ": ";
+        out += e;
+    }
+    out += '\n';
+}
+
+/* Դ fread ļ"-" Ϊ׼룩г string_viewȥβ '\r'
+   ģʽпбʾģʽûжӦĽ */
+bool readLines(const char* path, string& data, vector<string_view>& lines) {
+    FILE* fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (!fp) return false;
+    const size_t BUF = 1 << 20;
+    size_t n = 0;
+    for (;;) {
+        data.resize(n + BUF);
+        size_t r = fread(&data[n], 1, BUF, fp);
+        n += r;
+        if (r < BUF) break;
+    }
+    data.resize(n);
+    if (fp != stdin) fclose(fp);
+    for (size_t i = 0; i < n; ) {
+        size_t j = data.find('\n', i);
+        if (j == string::npos) j = n;
+        size_t e = (j > i && data[j - 1] == '\r') ? j - 1 : j;
+        if (e > i) lines.push_back(string_view(data.data() + i, e - i));
+        i = j + 1;
+    }
+    return true;
+}
+
+struct BatchChunk {
+    size_t lo, hi;          // кŷΧ [lo, hi)
+    string out;
+    bool done;
+};
+
+struct BatchJob {
+    const vector<string_view>* lines;
+    vector<BatchChunk> chunks;
+    vector<float> latNs;    // ÿֵʱ
+    atomic<size_t> next;    // һȡĿ
+    mutex mu;
+    condition_variable cv;
+};
+
+static void batchWorker(BatchJob* job) {
+    for (size_t k; (k = job->next.fetch_add(1)) < job->chunks.size(); ) {
+        BatchChunk& c = job->chunks[k];
+        string out;
+        out.reserve((c.hi - c.lo) * 24);
+        for (size_t i = c.lo; i < c.hi; ++i) {
+            double t0 = nowNs();
+            formatLine((*job->lines)[i], out);
+            job->latNs[i] = (float)(nowNs() - t0);
+        }
+        lock_guard<mutex> g(job->mu);
+        c.out.swap(out);
+        c.done = true;
+        job->cv.notify_all();
+    }
+}
+
+/* nThreads <= 1 ʱΪ˳·ֵͬһʽڶ */
+int runBatch(const char* path, int nThreads, FILE* dst) {
+    string data;
+    vector<string_view> lines;
+    if (!readLines(path, data, lines)) { fprintf(stderr, "޷ %s\n", path); return 1; }
+    const size_t CHUNK = 4096;
+    BatchJob job;
+    job.lines = &lines;
+    job.latNs.resize(lines.size());
+    job.next = 0;
+    for (size_t lo = 0; lo < lines.size(); lo += CHUNK) {
+        BatchChunk c = { lo, min(lines.size(), lo + CHUNK), string(), false };
+        job.chunks.push_back(c);
+    }
+    double t0 = nowNs();
+    if (nThreads <= 1) {
+        string out;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            double l0 = nowNs();
+            formatLine(lines[i], out);
+            job.latNs[i] = (float)(nowNs() - l0);
+            if (out.size() >= (1 << 20)) { fwrite(out.data(), 1, out.size(), dst); out.clear(); }
+        }
+        fwrite(out.data(), 1, out.size(), dst);
+    } else {
+        vector<thread> pool;
+        for (int t = 0; t < nThreads; ++t) pool.push_back(thread(batchWorker, &job));
+        for (size_t k = 0; k < job.chunks.size(); ++k) {      // ɵĺȻ
+            BatchChunk& c = job.chunks[k];
+            {
+                unique_lock<mutex> g(job.mu);
+                while (!c.done) job.cv.wait(g);
+            }
+            fwrite(c.out.data(), 1, c.out.size(), dst);
+            string().swap(c.out);
+        }
+        for (int t = 0; t < nThreads; ++t) pool[t].join();
+    }
+    fflush(dst);
+    double secs = (nowNs() - t0) / 1e9;
+    size_t nl = lines.size();
+    float p99 = 0;
+    if (nl) {
+        vector<float> lat = job.latNs;
+        nth_element(lat.begin(), lat.begin() + (nl - 1) * 99 / 100, lat.end());
+        p99 = lat[(nl - 1) * 99 / 100];
+    }
+    fprintf(stderr, "%zu У%d ̣߳%.3f s%.0f /sp99 %.0f ns/\n",
+            nl, max(nThreads, 1), secs, secs > 0 ? nl / secs : 0.0, p99);
+    return 0;
+}
+
+/* Zipf ֲĹʽأ/޻ʱÿƽʱ */
+void benchCache(int distinct, size_t cap, int requests) {
+    vector<string> formulas(distinct);
+    for (int k = 0; k < distinct; ++k) {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "sin(x) * %d + sqrt(x + %d) / (x + 1) - ln(x) * %d.5 ^ 2", k % 97 + 1, k, k % 13);
+        formulas[k] = buf;
+    }
+    vector<double> cdf(distinct);
+    double acc = 0;
+    for (int k = 0; k < distinct; ++k) cdf[k] = acc += 1.0 / pow(k + 1, 1.1);
+    mt19937 rng(42);
+    uniform_real_distribution<double> u(0, acc);
+    vector<int> pick(requests);
+    for (int r = 0; r < requests; ++r) pick[r] = (int)(lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin());
+
+    double x = 2.5, sum1 = 0, sum2 = 0;
+    double t0 = nowNs();
+    for (int r = 0; r < requests; ++r) sum1 += compile(formulas[pick[r]]).eval(&x);
+    double t1 = nowNs();
+    ProgramCache cache(cap);
+    for (int r = 0; r < requests; ++r) sum2 += cache.eval(formulas[pick[r]], &x);
+    double t2 = nowNs();
+    printf("%d ʽ %zu%d ޻ %.0f ns/Σл %.0f ns/Σ %.1f%%̭ %zu Σ%s\n",
+           distinct, cap, requests, (t1 - t0) / requests, (t2 - t1) / requests, cache.hitRate() * 100,
+           cache.evictCount(), sum1 == sum2 ? "һ" : "һ");
+}
+
+/* ڹʽ vs Program::eval vs evaluate() */
+static constexpr ce::Prog CE_CONST = ce::compile("1 + 2 * (3 + 4) / 5 - 6 + 2 ^ 10 - 3!");
+static constexpr ce::Prog CE_TRIG  = ce::compile("sin(x) * sin(x) + cos(x) * cos(x) + ln(x) / 2 + (x + 1) * (x - 1)");
+static constexpr ce::Prog CE_POLY  = ce::compile("x ^ 2 + 2 * x * y + sqrt(16) * y");
+static_assert(CE_CONST.isConst() && CE_CONST.value() > 1015.79 && CE_CONST.value() < 1015.81, "ʽӦڱ۵");
+static_assert(CE_POLY.nvars == 2 && CE_POLY.n == 13, "ʽָ");
+
+void benchConstexpr(int rounds) {
+    const char* f = "sin(x) * sin(x) + cos(x) * cos(x) + ln(x) / 2 + (x + 1) * (x - 1)";
+    const int NX = 1000;
+    vector<string> texts(NX);
+    vector<double> xs(NX);
+    for (int k = 0; k < NX; ++k) { xs[k] = 1.5 + k * 0.25; texts[k] = substVar(f, "x", xs[k]); }
+    Program p = compile(f);
+    double s1 = 0, s2 = 0, s3 = 0;
+    double t0 = nowNs();
+    for (int r = 0; r < rounds; ++r) s1 += evaluate(texts[r % NX]);
+    double t1 = nowNs();
+    for (int r = 0; r < rounds; ++r) s2 += p.eval(&xs[r % NX]);
+    double t2 = nowNs();
+    for (int r = 0; r < rounds; ++r) s3 += ce::eval<CE_TRIG>(&xs[r % NX]);
+    double t3 = nowNs();
+    double c1 = 0, c2 = 0;
+    double t4 = nowNs();
+    for (int r = 0; r < rounds; ++r) c1 += evaluate("1 + 2 * (3 + 4) / 5 - 6 + 2 ^ 10 - 3!");
+    double t5 = nowNs();
+    for (int r = 0; r < rounds; ++r) c2 += ce::eval<CE_CONST>();
+    double t6 = nowNs();
+    double xy[2] = { 3, 0.5 };
+    printf("ڹʽ\n  %s\n  evaluate %.1f ns/ΣProgram::eval %.1f ns/Σce::eval %.1f ns/Σ%s\n",
+           f, (t1 - t0) / rounds, (t2 - t1) / rounds, (t3 - t2) / rounds,
+           fabs(s1 - s3) <= 1e-9 * fabs(s1) && s2 == s3 ? "һ" : "һ");
+    printf("  ʽ۵Ϊ %gevaluate %.1f ns/Σce::eval %.2f ns/Σx^2+2xy+sqrt(16)y(3, 0.5) = %g\n",
+           CE_CONST.value(), (t5 - t4) / rounds, (t6 - t5) / rounds, ce::eval<CE_POLY>(xy));
+    if (fabs(c1 - c2) > 1e-9 * fabs(c1)) puts("  ʽһ");
+}
+
+/* ۵ĳ evaluate() գexact Ϊsqrtݣλһ£
+    libm 룬 1 ulp ce ռ俪ͷ˵ */
+struct FoldCase { const char* text; bool exact; double folded; };
+#define FOLD_CASE(s, exact) { s, exact, ce::compile(s).value() }
+static constexpr FoldCase FOLD_CASES[] = {
+    FOLD_CASE("0.3", true), FOLD_CASE("0.1 + 0.2", true), FOLD_CASE("2.718281828", true),
+    FOLD_CASE("0.0000000000001", true), FOLD_CASE("3.14159265358979323846264338327950288", true),
+    FOLD_CASE("123456789012345678901234567890", true), FOLD_CASE("9007199254740993", true),
+    FOLD_CASE("0.000000000000000000000000000000123456789", true),
+    FOLD_CASE("1.1 ^ 10", true), FOLD_CASE("2 ^ 10 - 3!", true), FOLD_CASE("1 + 2 * (3 + 4) / 5 - 6", true),
+    FOLD_CASE("sqrt(2)", true), FOLD_CASE("sqrt(0.3)", true), FOLD_CASE("sqrt(1000000007)", true),
+    FOLD_CASE("2 ^ 0.5", false), FOLD_CASE("2 ^ 0.1", false), FOLD_CASE("10 ^ 0.3", false),
+    FOLD_CASE("2.5 ^ 3.7", false), FOLD_CASE("ln(2.718281828)", false), FOLD_CASE("ln(10)", false),
+    FOLD_CASE("ln(0.001)", false), FOLD_CASE("log(1000)", false), FOLD_CASE("log(100)", false),
+    FOLD_CASE("log(2)", false), FOLD_CASE("sin(1)", false), FOLD_CASE("cos(2.5)", false),
+    FOLD_CASE("tan(0.7)", false), FOLD_CASE("tan(3.14159265/4)", false), FOLD_CASE("sin(0) + cos(0)", false)
+};
+#undef FOLD_CASE
+
+/* ֮ͬ ulp  */
+static long long ulpDist(double a, double b) {
+    long long ia, ib;
+    memcpy(&ia, &a, 8);
+    memcpy(&ib, &b, 8);
+    if ((ia < 0) != (ib < 0)) return a == b ? 0 : numeric_limits<long long>::max();
+    return ia > ib ? ia - ib : ib - ia;
+}
+
+int checkConstFold() {
+    int n = sizeof(FOLD_CASES) / sizeof(FOLD_CASES[0]), same = 0, oneUlp = 0, bad = 0;
+    for (int k = 0; k < n; ++k) {
+        const FoldCase& fc = FOLD_CASES[k];
+        long long d = ulpDist(fc.folded, evaluate(fc.text));
+        if (d == 0) ++same;
+        else if (d == 1 && !fc.exact) ++oneUlp;
+        else {
+            printf("  %s %.17gevaluate %.17g\n", fc.text, fc.folded, evaluate(fc.text));
+            ++bad;
+        }
+    }
+    printf("ڳ۵ evaluate() գ%d λһ %d 1 ulplibm δȷ룩%d %d\n",
+           n, same, oneUlp, bad);
+    return bad;
+}
+
 /* */
-int main() {
+/* ÷job1_2 --batch <ļ|-> [߳]д׼ͳд׼
+         job1_2 --bench  ʾ׼Լ죨ִСѧ˾ȡ桢۵뽻
+         job1_2          ʾ뽻ģʽ */
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "--batch") == 0) {
+        int nThreads = argc >= 4 ? atoi(argv[3]) : (int)thread::hardware_concurrency();
+        return runBatch(argv[2], nThreads, stdout);
+    }
+
     const char* tests[] = {
         "1 + 2 * 3",
         "( 1 + 2 ) * 3",
@@ -215,6 +1614,7 @@ int main() {
         "1 + 2 * (3 + 4) / 5 - 6",
         "tan(3.14159265/4)",
         "log(100)",
+        "2 ^ 10 - 3!",
         "1 + + 2",
         "5 / 0"
     };
@@ -229,16 +1629,44 @@ int main() {
         cout << endl;
     }
 
-    /* ģʽ */
-    cout << "ʽ˳" << endl;
-    string line;
-    while (getline(cin, line)) {
-        if (line.empty()) break;
+    if (argc < 2 || strcmp(argv[1], "--bench") != 0) {
+        /* ģʽ */
+        cout << "ʽ˳" << endl;
+        string line;
+        while (getline(cin, line)) {
+            if (line.empty()) break;
+            try {
+                cout << " = " << evaluate(line) << endl;
+            } catch (const char* e) {
+                cout << ": " << e << endl;
+            }
+        }
+        return 0;
+    }
+
+    cout << "evaluate() " << endl;
+    benchEvaluate(tests, n, 100000);
+
+    /* ִУ evaluate() գʽ۵Ϊһָ */
+    cout << "ִУ" << endl;
+    for (int i = 0; i < n; ++i) {
         try {
-            cout << " = " << evaluate(line) << endl;
+            Program p = compile(tests[i]);
+            cout << tests[i] << "  => " << p.code.size() << " ָ = " << p.eval() << endl;
         } catch (const char* e) {
-            cout << ": " << e << endl;
+            cout << tests[i] << "  => : " << e << endl;
         }
     }
+    Program pxy = compile("x ^ 2 + 2 * x * y + sqrt(16) * y");
+    double xy[2] = { 3, 0.5 };
+    cout << "x=3, y=0.5 ʱ x^2+2xy+sqrt(16)y = " << pxy.eval(xy) << "" << pxy.code.size() << " ָ" << endl;
+    benchCompiled("sin(x) * sin(x) + cos(x) * cos(x) + ln(x) / 2 + (x + 1) * (x - 1)", 200000);
+    benchCompiled("sqrt(x) * 2 + 1 + 2 * (3 + 4) / 5 - 6", 200000);
+    cout << "ѧ˾ȣ" << endl;
+    checkKernels();
+    benchBatch(1000000);
+    benchCache(1000, 256, 200000);
+    checkConstFold();
+    benchConstexpr(200000);
     return 0;
 }
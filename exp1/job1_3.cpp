@@ -4,6 +4,14 @@
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <functional>
 using namespace std;
 
 /* ״ͼջ */
@@ -28,14 +36,728 @@ int largestRectangleArea(vector<int>& heights)
     return maxArea;
 }
 
+/* ʽΣ߶ι룬Ҫ鳣פڴ
+   ջÿӼ¼쵽㣬ջڸ߶ϸ± 64 λ */
+struct Bar
+{
+    long long start;             // ±꣨ǰ׺Сֵϵʾöϵλã
+    int h;
+    Bar() {}                     // ʼιʱԤݲ
+    Bar(long long s, int v) : start(s), h(v) {}
+};
+
+class HistogramStream
+{
+public:
+    explicit HistogramStream(long long begin = 0) : n(begin), best(0) {}
+    void push(int h)
+    {
+        long long start = n;
+        while (!stk.empty() && stk.back().h >= h)
+        {
+            best = max(best, (long long)stk.back().h * (n - stk.back().start));
+            start = stk.back().start;
+            stk.pop_back();
+        }
+        Bar b = { start, h };
+        stk.push_back(b);
+        ++n;
+    }
+    void push(const int* h, size_t cnt)  // ι룺̶СƬÿƬȰջƬ
+    {                                     // ջֵھֲջʵʶռĿռ䲻һƬ
+        const size_t SLICE = 4096;
+        long long i = n, b = best;
+        for (size_t off = 0; off < cnt; off += SLICE)
+        {
+            size_t m = min(SLICE, cnt - off), top = stk.size();
+            stk.resize(top + m);
+            Bar* s = &stk[0];
+            for (size_t k = off; k < off + m; ++k, ++i)
+            {
+                int x = h[k];
+                long long start = i;
+                while (top > 0 && s[top - 1].h >= x)
+                {
+                    --top;
+                    b = max(b, (long long)s[top].h * (i - s[top].start));
+                    start = s[top].start;
+                }
+                s[top].start = start;
+                s[top].h = x;
+                ++top;
+            }
+            stk.resize(top);
+        }
+        n = i;
+        best = b;
+    }
+    long long result() const     // ι벿ֵΣӰι
+    {
+        long long r = best;
+        for (size_t i = 0; i < stk.size(); ++i)
+            r = max(r, (long long)stk[i].h * (n - stk[i].start));
+        return r;
+    }
+    void reset(long long begin = 0)       // յջи
+    {
+        stk.clear();
+        n = begin;
+        best = 0;
+    }
+    long long count() const { return n; }
+    long long bestClosed() const { return best; }
+    const vector<Bar>& bars() const { return stk; }
+    void append(const vector<Bar>& left, const vector<Bar>& right, long long end, long long chunkBest);
+private:
+    vector<Bar> stk;
+    long long n, best;
+};
+
+/* һ߶ȵժҪȷ˿ǰ׺Сֵϵ㡢ɨʱĵջ */
+struct ChunkSummary
+{
+    long long begin, end;
+    long long best;
+    vector<Bar> left;            // λõ߶ϸݼ
+    vector<Bar> right;           // ջright[0] ΪСֵΪ begin
+};
+
+class ChunkBuilder
+{
+public:
+    explicit ChunkBuilder(long long begin) : s(begin) { sum.begin = begin; }
+    void push(const int* h, size_t cnt)
+    {
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            if (sum.left.empty() || h[i] < sum.left.back().h)
+            {
+                Bar b = { s.count(), h[i] };
+                sum.left.push_back(b);
+            }
+            s.push(h[i]);
+        }
+    }
+    ChunkSummary& finish()
+    {
+        sum.end = s.count();
+        sum.best = s.bestClosed();
+        sum.right = s.bars();
+        return sum;
+    }
+private:
+    HistogramStream s;
+    ChunkSummary sum;
+};
+
+/* ѽںһӵǰϣ
+   Կǰ׺Сֵϵջϵ֮ĸ߶ȶڶϵֵЧͬι룻
+   ֮ջǿСֵٽϿɨʱջ */
+void HistogramStream::append(const vector<Bar>& left, const vector<Bar>& right, long long end, long long chunkBest)
+{
+    if (left.empty()) return;
+    for (size_t k = 0; k < left.size(); ++k)
+    {
+        long long p = left[k].start, start = p;
+        while (!stk.empty() && stk.back().h >= left[k].h)
+        {
+            best = max(best, (long long)stk.back().h * (p - stk.back().start));
+            start = stk.back().start;
+            stk.pop_back();
+        }
+        Bar b = { start, left[k].h };
+        stk.push_back(b);
+    }
+    stk.insert(stk.end(), right.begin() + 1, right.end());
+    n = end;
+    best = max(best, chunkBest);
+}
+
+/* 64 λ޸İ汾 largestRectangleArea ͬ int ʱ */
+long long largestRectangleArea64(const vector<int>& heights)
+{
+    HistogramStream s;
+    if (!heights.empty()) s.push(&heights[0], heights.size());
+    return s.result();
+}
+
+/* зΣ̶߳ɨһεõժҪٰ˳ժҪ */
+long long largestRectangleParallel(const vector<int>& heights, int nThreads)
+{
+    long long n = (long long)heights.size();
+    if (nThreads < 1) nThreads = 1;
+    vector<ChunkSummary> sums(nThreads);
+    vector<thread> pool;
+    for (int t = 0; t < nThreads; ++t)
+        pool.push_back(thread([&, t]()
+        {
+            long long b = n * t / nThreads, e = n * (t + 1) / nThreads;
+            ChunkBuilder cb(b);
+            if (e > b) cb.push(&heights[b], (size_t)(e - b));
+            sums[t] = cb.finish();
+        }));
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+    HistogramStream s;
+    for (int t = 0; t < nThreads; ++t)
+        s.append(sums[t].left, sums[t].right, sums[t].end, sums[t].best);
+    return s.result();
+}
+
+/* ļеĸ߶ȣint32 ƣÿ̶߳ԼһΣ߳ʱʽ
+   򲻿ļȡļȻλʧܡԪļʱ -1 */
+long long largestRectangleFile(const char* path, int nThreads)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+    long long bytes = fseeko(f, 0, SEEK_END) == 0 ? (long long)ftello(f) : -1;
+    fclose(f);
+    if (bytes < 0) return -1;
+    long long n = bytes / (long long)sizeof(int);
+    if (nThreads < 1) nThreads = 1;
+    vector<ChunkSummary> sums(nThreads);
+    atomic<bool> failed(false);
+    vector<thread> pool;
+    for (int t = 0; t < nThreads; ++t)
+        pool.push_back(thread([&, t]()
+        {
+            long long b = n * t / nThreads, e = n * (t + 1) / nThreads;
+            ChunkBuilder cb(b);
+            FILE* in = fopen(path, "rb");
+            if (!in || fseeko(in, b * (long long)sizeof(int), SEEK_SET) != 0)
+            {
+                if (in) fclose(in);
+                failed = true;
+                return;
+            }
+            vector<int> buf(1 << 18);
+            for (long long p = b; p < e; )
+            {
+                size_t want = (size_t)min<long long>((long long)buf.size(), e - p);
+                size_t got = fread(&buf[0], sizeof(int), want, in);
+                if (got == 0)                   //p < e ʱݣļضϻ
+                {
+                    failed = true;
+                    break;
+                }
+                cb.push(&buf[0], got);
+                p += (long long)got;
+            }
+            fclose(in);
+            sums[t] = cb.finish();
+        }));
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+    if (failed) return -1;
+    HistogramStream s;
+    for (int t = 0; t < nThreads; ++t)
+        s.append(sums[t].left, sums[t].right, sums[t].end, sums[t].best);
+    return s.result();
+}
+
+/* λѹ 0/1 ÿ words  32 λ֣ c ڵ c/32 ֵĵ c%32 λ */
+struct BitGrid
+{
+    int rows, cols, words;
+    vector<unsigned> bits;
+    BitGrid(int r, int c) : rows(r), cols(c), words((c + 31) / 32), bits((size_t)r * ((c + 31) / 32), 0) {}
+    unsigned* row(int r) { return &bits[(size_t)r * words]; }
+    const unsigned* row(int r) const { return &bits[(size_t)r * words]; }
+    void set(int r, int c) { bits[(size_t)r * words + c / 32] |= 1u << (c % 32); }
+    bool get(int r, int c) const { return (bits[(size_t)r * words + c / 32] >> (c % 32)) & 1; }
+};
+
+static const unsigned BIT32[32] =
+{
+    1u << 0,  1u << 1,  1u << 2,  1u << 3,  1u << 4,  1u << 5,  1u << 6,  1u << 7,
+    1u << 8,  1u << 9,  1u << 10, 1u << 11, 1u << 12, 1u << 13, 1u << 14, 1u << 15,
+    1u << 16, 1u << 17, 1u << 18, 1u << 19, 1u << 20, 1u << 21, 1u << 22, 1u << 23,
+    1u << 24, 1u << 25, 1u << 26, 1u << 27, 1u << 28, 1u << 29, 1u << 30, 1u << 31
+};
+
+/* һеλиߣλΪ 1  1Ϊ 0 
+   ڲ 32 ѭóλ룬չ SIMD Ƚѡ */
+void updateHeights(int* __restrict h, const unsigned* __restrict row, int cols)
+{
+    int full = cols / 32;
+    for (int w = 0; w < full; ++w)
+    {
+        unsigned bits = row[w];
+        int* __restrict p = h + w * 32;
+        for (int k = 0; k < 32; ++k)
+            p[k] = (bits & BIT32[k]) ? p[k] + 1 : 0;
+    }
+    for (int c = full * 32; c < cols; ++c)
+        h[c] = (row[full] >> (c % 32)) & 1 ? h[c] + 1 : 0;
+}
+
+/* ȫ 1 ӾΣииߣٶи״ͼΣиͬһջ
+   ߳ʱзִһ 0 βиߣ˳Ƴÿʼиߣڶ */
+long long maximalRectangle(const BitGrid& g, int nThreads = 1)
+{
+    int bands = max(1, min(nThreads, g.rows));
+    vector<int> cut(bands + 1);
+    for (int b = 0; b <= bands; ++b) cut[b] = (int)((long long)g.rows * b / bands);
+    vector<vector<int> > start(bands, vector<int>(g.cols, 0));
+    if (bands > 1)
+    {
+        vector<vector<int> > tail(bands, vector<int>(g.cols, 0));
+        vector<thread> pool;
+        for (int b = 0; b + 1 < bands; ++b)
+            pool.push_back(thread([&, b]()
+            {
+                for (int r = cut[b]; r < cut[b + 1]; ++r) updateHeights(&tail[b][0], g.row(r), g.cols);
+            }));
+        for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+        for (int b = 0; b + 1 < bands; ++b)
+        {
+            int len = cut[b + 1] - cut[b];
+            for (int c = 0; c < g.cols; ++c)       // ȫ 1 нǰĸ߶
+                start[b + 1][c] = tail[b][c] == len ? start[b][c] + len : tail[b][c];
+        }
+    }
+    vector<long long> best(bands, 0);
+    vector<thread> pool;
+    for (int b = 0; b < bands; ++b)
+        pool.push_back(thread([&, b]()
+        {
+            vector<int>& h = start[b];
+            HistogramStream hs;
+            for (int r = cut[b]; r < cut[b + 1]; ++r)
+            {
+                updateHeights(&h[0], g.row(r), g.cols);
+                hs.reset();
+                hs.push(&h[0], h.size());
+                best[b] = max(best[b], hs.result());
+            }
+        }));
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+    return *max_element(best.begin(), best.end());
+}
+
+/* գÿиһ vector<int> и߽ largestRectangleArea */
+long long maximalRectangleNaive(const BitGrid& g)
+{
+    vector<int> h(g.cols, 0);
+    long long best = 0;
+    for (int r = 0; r < g.rows; ++r)
+    {
+        for (int c = 0; c < g.cols; ++c) h[c] = g.get(r, c) ? h[c] + 1 : 0;
+        vector<int> cp(h);
+        best = max(best, (long long)largestRectangleArea(cp));
+    }
+    return best;
+}
+
+/* ѯ߷Σ
+   ѯ [l, r]  [lo, hi] еʱȡ׺ [l, mid] ڡҰǰ׺ [mid+1, r] ڡеľΡ
+   ǰ߶ԽԤȫ׺/ǰ׺Ĵ𰸣еľΰСֵһ࣬
+   Ϊ"ǰ׺ֵ""һֱĳֵ"ѯ O(log^2 n) */
+struct RectQuery
+{
+    int l, r;                    // 
+};
+
+struct Line
+{
+    long long a, b;              // a * x + b
+    Line(long long a_ = 0, long long b_ = 0) : a(a_), b(b_) {}
+    long long at(long long x) const { return a * x + b; }
+};
+
+/* ɳ߶ [1, n]ֱĳֵ밴
+   Ǹս 0 ֱ߼ */
+class UndoLiChao
+{
+public:
+    void init(int n_)
+    {
+        n = n_;
+        tree.assign(4 * n + 4, Line());
+        log.clear();
+        marks.clear();
+    }
+    void insert(Line ln)
+    {
+        marks.push_back(log.size());
+        int node = 1, lo = 1, hi = n;
+        for (;;)
+        {
+            int mid = (lo + hi) / 2;
+            Line& cur = tree[node];
+            bool left = ln.at(lo) > cur.at(lo), m = ln.at(mid) > cur.at(mid);
+            if (m)
+            {
+                log.push_back(make_pair(node, cur));
+                swap(cur, ln);
+            }
+            if (lo == hi) return;
+            if (left != m) { node = 2 * node; hi = mid; }
+            else { node = 2 * node + 1; lo = mid + 1; }
+        }
+    }
+    void undo()
+    {
+        size_t m = marks.back();
+        marks.pop_back();
+        for (; log.size() > m; log.pop_back()) tree[log.back().first] = log.back().second;
+    }
+    long long query(int x) const
+    {
+        long long r = 0;
+        int node = 1, lo = 1, hi = n;
+        for (;;)
+        {
+            r = max(r, tree[node].at(x));
+            if (lo == hi) return r;
+            int mid = (lo + hi) / 2;
+            if (x <= mid) { node = 2 * node; hi = mid; }
+            else { node = 2 * node + 1; lo = mid + 1; }
+        }
+    }
+private:
+    int n;
+    vector<Line> tree;
+    vector<pair<int, Line> > log;          // (, 滻ֱ)
+    vector<size_t> marks;                  // ÿβǰ log ĳ
+};
+
+/* ֱֵ̬߶ÿ汾ֱߵ͹б±굥 */
+class HullTree
+{
+public:
+    void build(const vector<Line>& ln)
+    {
+        n = (int)ln.size();
+        pool.clear();
+        from.assign(4 * n + 4, 0);
+        to.assign(4 * n + 4, 0);
+        if (n > 0) build(ln, 1, 0, n);
+    }
+    long long query(int a, int b, long long x) const       // ± [a, b) ֱ x ֵΪ 0
+    {
+        return a < b ? query(1, 0, n, a, b, x) : 0;
+    }
+private:
+    int n;
+    vector<Line> pool;
+    vector<int> from, to;                  // ͹ pool еķΧ
+    static bool useless(const Line& l1, const Line& l2, const Line& l3)   // б l1 < l2 < l3 ʱ l2 Ƿ
+    {
+        return (__int128)(l1.b - l3.b) * (l2.a - l1.a) <= (__int128)(l1.b - l2.b) * (l3.a - l1.a);
+    }
+    void build(const vector<Line>& ln, int node, int s, int e)
+    {
+        from[node] = (int)pool.size();
+        bool asc = ln[s].a <= ln[e - 1].a;
+        for (int i = 0; i < e - s; ++i)
+        {
+            const Line& cur = ln[asc ? s + i : e - 1 - i];
+            if ((int)pool.size() > from[node] && pool.back().a == cur.a)
+            {
+                if (pool.back().b >= cur.b) continue;
+                pool.pop_back();
+            }
+            while ((int)pool.size() - from[node] >= 2 && useless(pool[pool.size() - 2], pool.back(), cur))
+                pool.pop_back();
+            pool.push_back(cur);
+        }
+        to[node] = (int)pool.size();
+        if (e - s == 1) return;
+        int m = (s + e) / 2;
+        build(ln, 2 * node, s, m);
+        build(ln, 2 * node + 1, m, e);
+    }
+    long long query(int node, int s, int e, int a, int b, long long x) const
+    {
+        if (a <= s && e <= b)      // ͹ϸֱ x ֵҷ
+        {
+            int lo = from[node], hi = to[node] - 1;
+            while (lo < hi)
+            {
+                int m = (lo + hi) / 2;
+                if (pool[m].at(x) < pool[m + 1].at(x)) lo = m + 1; else hi = m;
+            }
+            return pool[lo].at(x);
+        }
+        int m = (s + e) / 2;
+        long long r = 0;
+        if (a < m) r = max(r, query(2 * node, s, m, a, b, x));
+        if (b > m) r = max(r, query(2 * node + 1, m, e, a, b, x));
+        return r;
+    }
+};
+
+class RangeRectSolver
+{
+public:
+    explicit RangeRectSolver(const vector<int>& heights) : h(heights) {}
+    void solve(const vector<RectQuery>& qs, vector<long long>& ans)
+    {
+        ans.assign(qs.size(), 0);
+        vector<int> ids(qs.size());
+        for (size_t i = 0; i < qs.size(); ++i) ids[i] = (int)i;
+        if (!h.empty()) solve(0, (int)h.size() - 1, ids, qs, ans);
+    }
+private:
+    const vector<int>& h;
+    UndoLiChao lc;
+    vector<Bar> stk;
+    vector<int> rev;
+
+    /* out[k] = a[0..k] ڵΣջÿӶӦֱ h * (x - start)
+       ջĽĲ/һһӦ */
+    void prefixBest(const int* a, int len, vector<long long>& out)
+    {
+        out.resize(len);
+        lc.init(len);
+        stk.clear();
+        long long best = 0;
+        for (int k = 0; k < len; ++k)
+        {
+            long long start = k;
+            while (!stk.empty() && stk.back().h >= a[k])
+            {
+                start = stk.back().start;
+                stk.pop_back();
+                lc.undo();
+            }
+            stk.push_back(Bar(start, a[k]));
+            lc.insert(Line(a[k], -(long long)a[k] * start));
+            best = max(best, lc.query(k + 1));
+            out[k] = best;
+        }
+    }
+
+    void solve(int lo, int hi, const vector<int>& ids, const vector<RectQuery>& qs, vector<long long>& ans)
+    {
+        if (ids.empty()) return;
+        if (lo == hi)
+        {
+            for (size_t i = 0; i < ids.size(); ++i) ans[ids[i]] = h[lo];
+            return;
+        }
+        int mid = (lo + hi) / 2;
+        vector<int> L, R, C;
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            const RectQuery& q = qs[ids[i]];
+            if (q.r <= mid) L.push_back(ids[i]);
+            else if (q.l > mid) R.push_back(ids[i]);
+            else C.push_back(ids[i]);
+        }
+        if (!C.empty()) cross(lo, mid, hi, C, qs, ans);
+        solve(lo, mid, L, qs, ans);
+        solve(mid + 1, hi, R, qs, ans);
+    }
+
+    void cross(int lo, int mid, int hi, const vector<int>& ids, const vector<RectQuery>& qs, vector<long long>& ans)
+    {
+        vector<long long> suf, pre;                // suf[mid - l] = [l, mid] ţpre[r - mid - 1] = [mid+1, r] 
+        rev.assign(h.rbegin() + (h.size() - 1 - mid), h.rbegin() + (h.size() - lo));
+        prefixBest(&rev[0], mid - lo + 1, suf);
+        prefixBest(&h[mid + 1], hi - mid, pre);
+
+        /* ࣺ mid ĺ׺Сֵ P[j] Ϊ H[j]ø߶쵽 lext[j]
+           Զ ext[j]Ҳǰ׺Сֵ H[j] λãΪ mid */
+        vector<int> P, H, lext, ext;
+        for (int a = mid, cur = INT_MAX; a >= lo; --a)
+            if (h[a] < cur) { cur = h[a]; P.push_back(a); H.push_back(h[a]); }
+        int nl = (int)P.size();
+        for (int j = 0, b = mid; j < nl; ++j)
+        {
+            lext.push_back(j + 1 < nl ? P[j + 1] + 1 : lo);
+            while (b < hi && h[b + 1] >= H[j]) ++b;
+            ext.push_back(b);
+        }
+        /* ҲԳƣǰ׺Сֵ Q[k] Ϊ G[k]쵽 rext[k]Զ extL[k] */
+        vector<int> Q, G, rext, extL;
+        for (int b = mid + 1, cur = INT_MAX; b <= hi; ++b)
+            if (h[b] < cur) { cur = h[b]; Q.push_back(b); G.push_back(h[b]); }
+        int nr = (int)Q.size();
+        for (int k = 0, a = mid + 1; k < nr; ++k)
+        {
+            rext.push_back(k + 1 < nr ? Q[k + 1] - 1 : hi);
+            while (a > lo && h[a - 1] >= G[k]) --a;
+            extL.push_back(a);
+        }
+
+        /* ˶ѯʽضϵľΪȡǰ׺󣻱һ˽ضϵǸö˵һκ */
+        vector<long long> PV(nl), PW(nr);
+        vector<Line> lf(nl), rg(nr);
+        for (int j = 0; j < nl; ++j)
+        {
+            PV[j] = max(j ? PV[j - 1] : 0, (long long)H[j] * (ext[j] - lext[j] + 1));
+            lf[j] = Line(H[j], -(long long)H[j] * (lext[j] - 1));          // Ҷ˽ rH * (r - lext + 1)
+        }
+        for (int k = 0; k < nr; ++k)
+        {
+            PW[k] = max(k ? PW[k - 1] : 0, (long long)G[k] * (rext[k] - extL[k] + 1));
+            rg[k] = Line(-G[k], (long long)G[k] * (rext[k] + 1));          // ˽ lG * (rext - l + 1)
+        }
+        HullTree lt, rt;
+        lt.build(lf);
+        rt.build(rg);
+
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            int l = qs[ids[i]].l, r = qs[ids[i]].r;
+            long long best = max(suf[mid - l], pre[r - mid - 1]);
+            int J = (int)(upper_bound(P.begin(), P.end(), l, greater<int>()) - P.begin()) - 1;   // һ P[j] >= l
+            int K = (int)(upper_bound(ext.begin(), ext.end(), r) - ext.begin());                // һ ext[j] > r
+            if (min(J, K) > 0) best = max(best, PV[min(J, K) - 1]);
+            best = max(best, lt.query(K, J, r));
+            best = max(best, (long long)H[J] * (min(r, ext[J]) - l + 1));
+            int K2 = (int)(upper_bound(Q.begin(), Q.end(), r) - Q.begin()) - 1;                 // һ Q[k] <= r
+            int M = (int)(upper_bound(extL.begin(), extL.end(), l, greater<int>()) - extL.begin());  // һ extL[k] < l
+            if (min(K2, M) > 0) best = max(best, PW[min(K2, M) - 1]);
+            best = max(best, rt.query(M, K2, l));
+            best = max(best, (long long)G[K2] * (r - max(l, extL[K2]) + 1));
+            ans[ids[i]] = best;
+        }
+    }
+};
+
 /*  [l, r]  */
 int randInt(int l, int r)
 {
     return l + rand() % (r - l + 1);
 }
 
-int main()
+double nowMs()
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* ״ͼ int32 ļļʽ㣻ǰ׺ֶڴԭ */
+void benchHuge(long long n, const char* path, int nThreads)
+{
+    double t0 = nowMs();
+    FILE* f = fopen(path, "wb");
+    if (!f) { cout << "޷д " << path << endl; return; }
+    vector<int> buf(1 << 20);
+    unsigned long long x = 88172645463325252ULL;
+    for (long long p = 0; p < n; )
+    {
+        size_t cnt = (size_t)min<long long>((long long)buf.size(), n - p);
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            buf[i] = (int)(x % 10000);
+        }
+        fwrite(&buf[0], sizeof(int), cnt, f);
+        p += (long long)cnt;
+    }
+    fclose(f);
+    cout << " " << n << " ߶ȵ " << path << "" << nowMs() - t0 << " ms" << endl;
+
+    long long m = min(n, 100000000LL);
+    vector<int> h((size_t)m);
+    f = fopen(path, "rb");
+    size_t got = fread(&h[0], sizeof(int), (size_t)m, f);
+    fclose(f);
+    h.resize(got);
+    t0 = nowMs();
+    long long a0 = largestRectangleArea(h);
+    double t1 = nowMs();
+    long long a1 = largestRectangleArea64(h);
+    double t2 = nowMs();
+    long long a2 = largestRectangleParallel(h, nThreads);
+    double t3 = nowMs();
+    cout << "ڴǰ " << m << " ԭ " << t1 - t0 << " ms64 λʽ " << t2 - t1
+         << " ms(" << nThreads << " ߳) " << t3 - t2 << " ms " << a0 << " / " << a1 << " / " << a2
+         << (a0 == a1 && a1 == a2 ? "һ" : "һ") << endl;
+    vector<int>().swap(h);
+
+    t0 = nowMs();
+    long long s1 = largestRectangleFile(path, 1);
+    t1 = nowMs();
+    long long sp = largestRectangleFile(path, nThreads);
+    t2 = nowMs();
+    if (s1 < 0 || sp < 0) { cout << "ȡ " << path << " ʧ" << endl; remove(path); return; }
+    cout << "ļȫ " << n << " ʽ " << t1 - t0 << " ms(" << nThreads << " ߳) " << t2 - t1
+         << " ms " << s1 << " / " << sp << (s1 == sp ? "һ" : "һ") << endl;
+    remove(path);
+}
+
+/* ȫ 1 ӾΣÿλΪ 1 ĸ 7/8 */
+void benchGrid(int n, int nThreads)
+{
+    double t0 = nowMs();
+    BitGrid g(n, n);
+    unsigned long long x = 88172645463325252ULL;
+    for (size_t i = 0; i < g.bits.size(); ++i)
+    {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        unsigned long long y = x;
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        g.bits[i] = (unsigned)y | (unsigned)(y >> 32) | (unsigned)x;     // ȡ
+    }
+    cout << " " << n << "x" << n << " λ" << g.bits.size() * 4 / 1048576 << " MB" << nowMs() - t0 << " ms" << endl;
+    t0 = nowMs();
+    long long a1 = maximalRectangle(g, 1);
+    double t1 = nowMs();
+    long long ap = maximalRectangle(g, nThreads);
+    double t2 = nowMs();
+    long long an = maximalRectangleNaive(g);
+    double t3 = nowMs();
+    cout << "maximalRectangle ߳ " << t1 - t0 << " ms" << nThreads << " ߳ " << t2 - t1
+         << " msи " << t3 - t2 << " ms " << a1 << " / " << ap << " / " << an
+         << (a1 == ap && ap == an ? "һ" : "һ") << endl;
+}
+
+/* 𴰿ڸƺ㣬ΪѯĶ */
+long long windowOracle(const vector<int>& h, const RectQuery& q)
+{
+    vector<int> w(h.begin() + q.l, h.begin() + q.r + 1);
+    return largestRectangleArea(w);
+}
+
+/* ѯ߷⣬𴰿ֻʱ */
+void benchQueries(int n, int q)
 {
+    vector<int> h(n);
+    for (int i = 0; i < n; ++i) h[i] = rand() % 10000;
+    vector<RectQuery> qs(q);
+    for (int i = 0; i < q; ++i)
+    {
+        int a = (int)((long long)rand() * rand() % n), b = (int)((long long)rand() * rand() % n);
+        qs[i].l = min(a, b);
+        qs[i].r = max(a, b);
+    }
+    double t0 = nowMs();
+    vector<long long> ans;
+    RangeRectSolver(h).solve(qs, ans);
+    double t1 = nowMs();
+    const int SAMPLE = 100;
+    bool ok = true;
+    for (int i = 0; i < SAMPLE && i < q; ++i) ok = ok && windowOracle(h, qs[i]) == ans[i];
+    double t2 = nowMs();
+    cout << "n = " << n << "" << q << " ѯ߷ι " << t1 - t0 << " ms" << (t1 - t0) * 1000 / q
+         << " us/𴰿 " << (t2 - t1) / min(SAMPLE, q) << " ms/ " << min(SAMPLE, q) << " "
+         << (ok ? "һ" : "һ") << endl;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--query") == 0)     // job1_3 --query [] [ѯ]
+    {
+        benchQueries(argc > 2 ? (int)atof(argv[2]) : 1000000, argc > 3 ? (int)atof(argv[3]) : 1000000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--grid") == 0)      // job1_3 --grid [߳] [߳]
+    {
+        int n = argc > 2 ? atoi(argv[2]) : 50000;
+        int nThreads = argc > 3 ? atoi(argv[3]) : (int)max(1u, thread::hardware_concurrency());
+        benchGrid(n, nThreads);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)     // job1_3 --bench [Ԫظ] [߳] [ļ]
+    {
+        long long n = argc > 2 ? (long long)atof(argv[2]) : 1000000000LL;
+        int nThreads = argc > 3 ? atoi(argv[3]) : (int)max(1u, thread::hardware_concurrency());
+        benchHuge(n, argc > 4 ? argv[4] : "heights.bin", nThreads);
+        return 0;
+    }
+
     srand((unsigned)time(NULL));
     const int TEST_CASES = 10;
 
@@ -49,7 +771,42 @@ int main()
         cout << " " << t << " 飺n = " << n ;
         cout << " ɵе" ;
 		for (size_t i = 0; i < heights.size(); ++i) cout << heights[i] << " ";
-		cout << " = " << largestRectangleArea(heights) << endl;
+		int area = largestRectangleArea(heights);
+		cout << " = " << area;
+		HistogramStream hs;
+		for (size_t i = 0; i < heights.size(); ++i) hs.push(heights[i]);
+		bool same = hs.result() == area && largestRectangleParallel(heights, randInt(1, 8)) == area;
+		cout << "ʽ/" << (same ? "һ" : "һ") << endl;
+    }
+    for (int t = 1; t <= TEST_CASES; ++t)
+    {
+        int r = randInt(1, 40), c = randInt(1, 100);
+        BitGrid g(r, c);
+        for (int i = 0; i < r; ++i)
+            for (int j = 0; j < c; ++j)
+                if (randInt(0, 9) < 8) g.set(i, j);
+        long long a = maximalRectangleNaive(g);
+        cout << " " << t << "  01 " << r << "x" << c << "ȫ 1 Ӿ = " << a
+             << (maximalRectangle(g, randInt(1, 8)) == a ? "λѹ汾һ" : "λѹ汾һ") << endl;
+    }
+    for (int t = 1; t <= TEST_CASES; ++t)
+    {
+        int n = randInt(1, 105), q = randInt(1, 200);
+        vector<int> heights(n);
+        for (int i = 0; i < n; ++i)
+            heights[i] = randInt(0, 104);
+        vector<RectQuery> qs(q);
+        for (int i = 0; i < q; ++i)
+        {
+            qs[i].l = randInt(0, n - 1);
+            qs[i].r = randInt(qs[i].l, n - 1);
+        }
+        vector<long long> ans;
+        RangeRectSolver(heights).solve(qs, ans);
+        int wrong = 0;
+        for (int i = 0; i < q; ++i) wrong += windowOracle(heights, qs[i]) != ans[i];
+        cout << " " << t << " ѯn = " << n << "" << q << " ڣ"
+             << (wrong ? "𴰿㲻һ" : "ȫ𴰿һ") << endl;
     }
     cout << "Խ" << endl;
     
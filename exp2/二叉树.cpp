@@ -5,6 +5,10 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
 using namespace std;
 
 typedef unsigned int Rank;
@@ -32,10 +36,11 @@ public:
     Bitmap( char* file, Rank n = 8 ) {     //ָĬϹģָļжȡλͼ
 	    init( n );
 		FILE* fp = fopen( file, "r" ); fread( M, sizeof( char ), N, fp ); fclose( fp );
-		for ( Rank k = 0, _sz = 0; k < n; k++ ) _sz += test(k);
+		_sz = 0; for ( Rank k = 0; k < n; k++ ) _sz += test(k);
 	}
     ~Bitmap() { delete[] M; M = NULL; _sz = 0; }       //ʱͷλͼռ
     Rank size() const { return _sz; }
+    Rank bytes() const { return N; }      //ʵռõֽ
     void set(Rank k) { expand(k); _sz++; M[k >> 3] |= (0x80 >> (k & 0x07)); }
     void clear(Rank k) { expand(k); _sz--; M[k >> 3] &= ~(0x80 >> (k & 0x07)); }
     bool test(Rank k) const { expand(k); return M[k >> 3] & (0x80 >> (k & 0x07)); }
@@ -52,21 +57,483 @@ public:
     }
 };
 
+/*  64 λִ洢λͼ Bitmap64λ k λ W[k >> 6] ĵ (k & 63) λλȣ
+   size() Ӳ popcountrank/select  buildRank() ĸ
+   ÿ 512 λ8 ֣һ飬¼ǰ 1 ĸrank O(1)select O(log n) */
+class Bitmap64 {
+public:
+    typedef unsigned long long Word;
+    static const Rank NPOS = ~0u;        //next()/select() δҵʱķֵ
+private:
+    vector<Word> W;
+    vector<unsigned long long> R;        //R[i] =  i ֮ǰ 1 ĸĩβ
+    bool dirty;                          //޸ĺ rank ʧЧ
+    static int pop(Word w) { return __builtin_popcountll(w); }
+    static const size_t MAXW = (1ULL << 32) / 64;   //Rank Ѱַ 2^32 λݲԽ
+    void expand(Rank k) {                // Bitmap һµļӱݣֻдʱ
+        if (k < capacity()) return;
+        W.resize(min(MAXW, max((size_t)(k / 64 + 1), 2 * W.size())), 0);
+    }
+    void fit(const Bitmap64& b) { if (b.W.size() > W.size()) W.resize(b.W.size(), 0); }
+public:
+    Bitmap64(Rank n = 64) : W((n + 63) / 64, 0), dirty(true) {}
+    Bitmap64(const char* file, Rank n = 64) : W((n + 63) / 64, 0), dirty(true) {   //ȡ dump() 
+        FILE* fp = fopen(file, "rb");
+        if (fp) { size_t r = fread(&W[0], sizeof(Word), W.size(), fp); (void)r; fclose(fp); }
+    }
+    unsigned long long capacity() const { return 64ULL * W.size(); }   //ɴ 2^32 Rank
+    Rank size() const {                  //λ
+        unsigned long long c = 0;
+        for (size_t i = 0; i < W.size(); i++) c += pop(W[i]);
+        return (Rank)c;
+    }
+    void set(Rank k)   { expand(k); W[k >> 6] |= 1ULL << (k & 63); dirty = true; }
+    void clear(Rank k) { if (k < capacity()) { W[k >> 6] &= ~(1ULL << (k & 63)); dirty = true; } }
+    bool test(Rank k) const { return k < capacity() && (W[k >> 6] >> (k & 63) & 1); }
+
+    /* ߼㣺ִѭ򵥣-O2/-O3 ɱԶ */
+    Bitmap64& andWith(const Bitmap64& b) {
+        size_t n = min(W.size(), b.W.size());
+        for (size_t i = 0; i < n; i++) W[i] &= b.W[i];
+        for (size_t i = n; i < W.size(); i++) W[i] = 0;
+        dirty = true; return *this;
+    }
+    Bitmap64& orWith(const Bitmap64& b) {
+        fit(b);
+        for (size_t i = 0; i < b.W.size(); i++) W[i] |= b.W[i];
+        dirty = true; return *this;
+    }
+    Bitmap64& xorWith(const Bitmap64& b) {
+        fit(b);
+        for (size_t i = 0; i < b.W.size(); i++) W[i] ^= b.W[i];
+        dirty = true; return *this;
+    }
+    Bitmap64& andNotWith(const Bitmap64& b) {
+        size_t n = min(W.size(), b.W.size());
+        for (size_t i = 0; i < n; i++) W[i] &= ~b.W[i];
+        dirty = true; return *this;
+    }
+
+    Rank next(Rank k) const {            //С k ĵһλڱ
+        size_t i = k >> 6;
+        if (i >= W.size()) return NPOS;
+        Word w = W[i] & (~0ULL << (k & 63));
+        while (!w) {
+            if (++i == W.size()) return NPOS;
+            w = W[i];
+        }
+        return (Rank)(i * 64 + __builtin_ctzll(w));
+    }
+
+    void buildRank() {
+        size_t nb = (W.size() + 7) / 8;
+        R.assign(nb + 1, 0);
+        for (size_t b = 0; b < nb; b++) {
+            unsigned long long c = 0;
+            for (size_t i = b * 8; i < min(W.size(), b * 8 + 8); i++) c += pop(W[i]);
+            R[b + 1] = R[b] + c;
+        }
+        dirty = false;
+    }
+    Rank rank(Rank k) const {            //[0, k)  1 ĸ buildRank()
+        if (k >= capacity()) return (Rank)R.back();
+        size_t i = k >> 6, b = i >> 3;
+        unsigned long long c = R[b];
+        for (size_t j = b * 8; j < i; j++) c += pop(W[j]);
+        return (Rank)(c + pop(W[i] & ((1ULL << (k & 63)) - 1)));
+    }
+    Rank select(Rank j) const {          // j  0 λλã buildRank()
+        if (j >= R.back()) return NPOS;
+        size_t b = upper_bound(R.begin(), R.end(), (unsigned long long)j) - R.begin() - 1;
+        j -= (Rank)R[b];
+        size_t i = b * 8;
+        for (int c; (c = pop(W[i])) <= (int)j; i++) j -= c;
+        Word w = W[i];
+        while (j--) w &= w - 1;          //ȥλ j  1
+        return (Rank)(i * 64 + __builtin_ctzll(w));
+    }
+    bool rankReady() const { return !dirty; }
+
+    void dump(const char* file) const {
+        FILE* fp = fopen(file, "wb");
+        fwrite(&W[0], sizeof(Word), W.size(), fp);
+        fclose(fp);
+    }
+    string bits2string(Rank n) const {   //ȡλλ test()
+        string s(n, '0');
+        for (unsigned long long i = 0; i < n && i < capacity(); i += 64) {
+            Word w = W[i >> 6];
+            for (Rank j = i; w && j < n; j++, w >>= 1) if (w & 1) s[j] = '1';
+        }
+        return s;
+    }
+};
+const size_t Bitmap64::MAXW;
+
+/* ѹλͼ RoaringBitmap 16 λ Rank  64K ֿ飬ÿ鰴ѡ
+   飨 16 λ4096 λ1024 ֣γ̣[, -1] ԣ
+   ޸ֻλrunOptimize() ٰʺϵĿΪγ̡ */
+class RoaringBitmap {
+public:
+    typedef unsigned long long Word;
+    enum { ARRAY, BITSET, RUN };
+    static const unsigned ARRAY_MAX = 4096;
+    struct Chunk {
+        unsigned short key;              // 16 λ
+        unsigned char type;
+        unsigned card;                   //λ
+        vector<unsigned short> arr;      //ARRAYֵRUN㡢-1 
+        vector<Word> bits;               //BITSET
+        Chunk(unsigned short k = 0) : key(k), type(ARRAY), card(0) {}
+        bool test(unsigned short lo) const {
+            if (type == BITSET) return bits[lo >> 6] >> (lo & 63) & 1;
+            if (type == ARRAY) return binary_search(arr.begin(), arr.end(), lo);
+            size_t lo2 = 0, hi2 = arr.size() / 2;      //һ <= lo γ
+            while (lo2 < hi2) {
+                size_t m = (lo2 + hi2) / 2;
+                if (arr[2 * m] <= lo) lo2 = m + 1; else hi2 = m;
+            }
+            return lo2 && lo <= arr[2 * lo2 - 2] + arr[2 * lo2 - 1];
+        }
+        void toBitset() {
+            if (type == BITSET) return;
+            vector<Word> b(1024, 0);
+            if (type == ARRAY)
+                for (size_t i = 0; i < arr.size(); i++) b[arr[i] >> 6] |= 1ULL << (arr[i] & 63);
+            else
+                for (size_t i = 0; i < arr.size(); i += 2)
+                    for (unsigned v = arr[i]; v <= (unsigned)arr[i] + arr[i + 1]; v++) b[v >> 6] |= 1ULL << (v & 63);
+            bits.swap(b); vector<unsigned short>().swap(arr); type = BITSET;
+        }
+        void toArray() {
+            if (type == ARRAY) return;
+            vector<unsigned short> a;
+            a.reserve(card);
+            if (type == BITSET) {
+                for (unsigned i = 0; i < 1024; i++)
+                    for (Word w = bits[i]; w; w &= w - 1) a.push_back((unsigned short)(i * 64 + __builtin_ctzll(w)));
+                vector<Word>().swap(bits);
+            } else {
+                for (size_t i = 0; i < arr.size(); i += 2)
+                    for (unsigned v = arr[i]; v <= (unsigned)arr[i] + arr[i + 1]; v++) a.push_back((unsigned short)v);
+            }
+            arr.swap(a); type = ARRAY;
+        }
+        void normalize() {               //صλ
+            if (type == RUN) { if (card <= ARRAY_MAX) toArray(); else toBitset(); }
+            else if (type == BITSET && card <= ARRAY_MAX) toArray();
+            else if (type == ARRAY && card > ARRAY_MAX) toBitset();
+        }
+        void recount() {
+            card = 0;
+            for (unsigned i = 0; i < 1024; i++) card += __builtin_popcountll(bits[i]);
+        }
+        size_t bytes() const { return sizeof(Chunk) + arr.capacity() * 2 + bits.capacity() * 8; }
+    };
+private:
+    vector<Chunk> C;                     // key 
+    Chunk* find(unsigned short key) {
+        vector<Chunk>::iterator it = lower_bound(C.begin(), C.end(), key, keyLess);
+        return (it != C.end() && it->key == key) ? &*it : NULL;
+    }
+    const Chunk* find(unsigned short key) const { return const_cast<RoaringBitmap*>(this)->find(key); }
+    static bool keyLess(const Chunk& c, unsigned short k) { return c.key < k; }
+public:
+    RoaringBitmap() {}
+    RoaringBitmap(const char* file) { load(file); }
+
+    bool test(Rank k) const {
+        const Chunk* c = find(k >> 16);
+        return c && c->test(k & 0xffff);
+    }
+    void set(Rank k) {
+        unsigned short key = k >> 16, lo = k & 0xffff;
+        vector<Chunk>::iterator it = lower_bound(C.begin(), C.end(), key, keyLess);
+        if (it == C.end() || it->key != key) it = C.insert(it, Chunk(key));
+        Chunk& c = *it;
+        if (c.type == RUN) { if (c.test(lo)) return; c.toBitset(); }
+        if (c.type == ARRAY) {
+            vector<unsigned short>::iterator p = lower_bound(c.arr.begin(), c.arr.end(), lo);
+            if (p != c.arr.end() && *p == lo) return;
+            c.arr.insert(p, lo);
+        } else {
+            Word& w = c.bits[lo >> 6];
+            if (w >> (lo & 63) & 1) return;
+            w |= 1ULL << (lo & 63);
+        }
+        c.card++;
+        c.normalize();
+    }
+    void clear(Rank k) {
+        unsigned short key = k >> 16, lo = k & 0xffff;
+        vector<Chunk>::iterator it = lower_bound(C.begin(), C.end(), key, keyLess);
+        if (it == C.end() || it->key != key || !it->test(lo)) return;
+        Chunk& c = *it;
+        if (c.type == RUN) c.toBitset();
+        if (c.type == ARRAY) c.arr.erase(lower_bound(c.arr.begin(), c.arr.end(), lo));
+        else c.bits[lo >> 6] &= ~(1ULL << (lo & 63));
+        if (--c.card == 0) C.erase(it); else c.normalize();
+    }
+    Rank size() const {
+        unsigned long long n = 0;
+        for (size_t i = 0; i < C.size(); i++) n += C[i].card;
+        return (Rank)n;
+    }
+    size_t bytes() const {
+        size_t b = sizeof(*this);
+        for (size_t i = 0; i < C.size(); i++) b += C[i].bytes();
+        return b;
+    }
+
+    void runOptimize() {                 //γ̸ʡռĿγ
+        for (size_t i = 0; i < C.size(); i++) {
+            Chunk& c = C[i];
+            if (c.type == RUN) continue;
+            c.toArray();
+            vector<unsigned short> r;
+            for (size_t j = 0; j < c.arr.size(); ) {
+                size_t e = j;
+                while (e + 1 < c.arr.size() && c.arr[e + 1] == c.arr[e] + 1) e++;
+                r.push_back(c.arr[j]); r.push_back((unsigned short)(c.arr[e] - c.arr[j]));
+                j = e + 1;
+            }
+            if (r.size() * 2 < min((size_t)c.card * 2, (size_t)8192)) { c.arr.swap(r); c.type = RUN; }
+            else c.normalize();
+        }
+    }
+
+    /* Ԫعˣఴλ */
+    RoaringBitmap& andWith(const RoaringBitmap& b) {
+        vector<Chunk> out;
+        size_t i = 0, j = 0;
+        while (i < C.size() && j < b.C.size()) {
+            if (C[i].key < b.C[j].key) { i++; continue; }
+            if (C[i].key > b.C[j].key) { j++; continue; }
+            Chunk& x = C[i];
+            const Chunk& y = b.C[j];
+            Chunk r(x.key);
+            if (x.type == ARRAY || y.type == ARRAY) {
+                const Chunk& a = (x.type == ARRAY) ? x : y;
+                const Chunk& o = (x.type == ARRAY) ? y : x;
+                for (size_t t = 0; t < a.arr.size(); t++)
+                    if (o.test(a.arr[t])) r.arr.push_back(a.arr[t]);
+                r.card = (unsigned)r.arr.size();
+            } else {
+                Chunk yb = y;
+                x.toBitset(); yb.toBitset();
+                r.bits = x.bits; r.type = BITSET;
+                for (unsigned t = 0; t < 1024; t++) r.bits[t] &= yb.bits[t];
+                r.recount();
+                r.normalize();
+            }
+            if (r.card) out.push_back(r);
+            i++; j++;
+        }
+        C.swap(out);
+        return *this;
+    }
+    /* 鲢ఴλֻ */
+    RoaringBitmap& orWith(const RoaringBitmap& b) {
+        vector<Chunk> out;
+        size_t i = 0, j = 0;
+        while (i < C.size() || j < b.C.size()) {
+            if (j == b.C.size() || (i < C.size() && C[i].key < b.C[j].key)) { out.push_back(C[i++]); continue; }
+            if (i == C.size() || C[i].key > b.C[j].key) { out.push_back(b.C[j++]); continue; }
+            Chunk& x = C[i];
+            const Chunk& y = b.C[j];
+            Chunk r(x.key);
+            if (x.type == ARRAY && y.type == ARRAY) {
+                set_union(x.arr.begin(), x.arr.end(), y.arr.begin(), y.arr.end(), back_inserter(r.arr));
+                r.card = (unsigned)r.arr.size();
+            } else {
+                Chunk yb = y;
+                x.toBitset(); yb.toBitset();
+                r.bits = x.bits; r.type = BITSET;
+                for (unsigned t = 0; t < 1024; t++) r.bits[t] |= yb.bits[t];
+                r.recount();
+            }
+            r.normalize();
+            out.push_back(r);
+            i++; j++;
+        }
+        C.swap(out);
+        return *this;
+    }
+
+    /* ֲлС"RBM1"  {key  Ԫ غ}ȡ dump()/ļ */
+    vector<unsigned char> serialize() const {
+        vector<unsigned char> o;
+        const char* magic = "RBM1";
+        for (int i = 0; i < 4; i++) o.push_back(magic[i]);
+        putLE(o, C.size(), 4);
+        for (size_t i = 0; i < C.size(); i++) {
+            const Chunk& c = C[i];
+            putLE(o, c.key, 2);
+            o.push_back(c.type);
+            putLE(o, c.card, 4);
+            if (c.type == BITSET) for (unsigned t = 0; t < 1024; t++) putLE(o, c.bits[t], 8);
+            else {
+                putLE(o, c.arr.size(), 4);
+                for (size_t t = 0; t < c.arr.size(); t++) putLE(o, c.arr[t], 2);
+            }
+        }
+        return o;
+    }
+    /* 벻ţ͡key ϸҲ ARRAY_MAXγ̲Խ 65535 һص
+       Ԫغһ£κһ㶼ܾչγʱд 1024 ֵλ */
+    bool deserialize(const vector<unsigned char>& in) {
+        C.clear();
+        size_t p = 0;
+        if (in.size() < 8 || memcmp(&in[0], "RBM1", 4)) return false;
+        p = 4;
+        size_t n = (size_t)getLE(in, p, 4);
+        for (size_t i = 0; i < n; i++) {
+            if (p + 7 > in.size()) { C.clear(); return false; }
+            Chunk c((unsigned short)getLE(in, p, 2));
+            c.type = in[p++];
+            c.card = (unsigned)getLE(in, p, 4);
+            if (c.type == BITSET) {
+                if (p + 8192 > in.size()) { C.clear(); return false; }
+                c.bits.resize(1024);
+                for (unsigned t = 0; t < 1024; t++) c.bits[t] = getLE(in, p, 8);
+            } else {
+                size_t m = (size_t)getLE(in, p, 4);
+                if (p + 2 * m > in.size()) { C.clear(); return false; }
+                c.arr.resize(m);
+                for (size_t t = 0; t < m; t++) c.arr[t] = (unsigned short)getLE(in, p, 2);
+            }
+            if (!C.empty() && C.back().key >= c.key) { C.clear(); return false; }
+            if (!validChunk(c)) { C.clear(); return false; }
+            C.push_back(c);
+        }
+        if (p != in.size()) { C.clear(); return false; }
+        return true;
+    }
+    static bool validChunk(const Chunk& c) {
+        unsigned long long cnt = 0;
+        if (c.type == BITSET) {
+            for (unsigned t = 0; t < 1024; t++) cnt += __builtin_popcountll(c.bits[t]);
+        } else if (c.type == ARRAY) {
+            if (c.arr.size() > ARRAY_MAX) return false;
+            for (size_t t = 1; t < c.arr.size(); t++)
+                if (c.arr[t] <= c.arr[t - 1]) return false;
+            cnt = c.arr.size();
+        } else if (c.type == RUN) {
+            if (c.arr.size() % 2) return false;
+            long prevEnd = -1;
+            for (size_t t = 0; t < c.arr.size(); t += 2) {
+                long st = c.arr[t], end = st + c.arr[t + 1];
+                if (end > 65535 || st <= prevEnd) return false;
+                cnt += end - st + 1;
+                prevEnd = end;
+            }
+        } else return false;
+        return cnt == c.card;
+    }
+    void dump(const char* file) const {
+        vector<unsigned char> o = serialize();
+        FILE* fp = fopen(file, "wb");
+        fwrite(&o[0], 1, o.size(), fp);
+        fclose(fp);
+    }
+    bool load(const char* file) {
+        FILE* fp = fopen(file, "rb");
+        if (!fp) return false;
+        vector<unsigned char> in;
+        unsigned char buf[4096];
+        for (size_t r; (r = fread(buf, 1, sizeof(buf), fp)) > 0; ) in.insert(in.end(), buf, buf + r);
+        fclose(fp);
+        return deserialize(in);
+    }
+private:
+    static void putLE(vector<unsigned char>& o, unsigned long long v, int n) {
+        for (int i = 0; i < n; i++) o.push_back((unsigned char)(v >> (8 * i)));
+    }
+    static unsigned long long getLE(const vector<unsigned char>& in, size_t& p, int n) {
+        unsigned long long v = 0;
+        for (int i = 0; i < n && p < in.size(); i++) v |= (unsigned long long)in[p++] << (8 * i);
+        return v;
+    }
+};
+
+/* λͼ ConcurrentBitmap̹߳ visited/ȥؼϡ
+   η䣨ÿ 2^20 λĿ¼̶ Rank Χ״дʱ CAS װ
+   еƣset/clear Ϊ 64 λϵԭ fetch_or/fetch_andԭֵ */
+class ConcurrentBitmap {
+public:
+    typedef unsigned long long Word;
+    static const int SEG_BITS = 20;
+    static const Rank SEG_WORDS = (1u << SEG_BITS) / 64;
+    static const Rank SEGS = 1u << (32 - SEG_BITS);
+private:
+    atomic<atomic<Word>*> seg[SEGS];     //Ŀ¼λֻɿձΪǿ
+    atomic<Word>* segment(Rank k, bool create) {
+        atomic<atomic<Word>*>& slot = seg[k >> SEG_BITS];
+        atomic<Word>* p = slot.load(memory_order_acquire);
+        if (p || !create) return p;
+        atomic<Word>* fresh = new atomic<Word>[SEG_WORDS];
+        for (Rank i = 0; i < SEG_WORDS; i++) fresh[i].store(0, memory_order_relaxed);
+        if (slot.compare_exchange_strong(p, fresh, memory_order_acq_rel, memory_order_acquire))
+            return fresh;
+        delete[] fresh;                  //߳Ȱװʹ
+        return p;
+    }
+    const atomic<Word>* segment(Rank k) const { return seg[k >> SEG_BITS].load(memory_order_acquire); }
+    ConcurrentBitmap(const ConcurrentBitmap&);
+    ConcurrentBitmap& operator=(const ConcurrentBitmap&);
+public:
+    ConcurrentBitmap(Rank n = 0) {       //Ԥ [0, n) ڵĶΣɱз
+        for (Rank i = 0; i < SEGS; i++) seg[i].store(NULL, memory_order_relaxed);
+        reserve(n);
+    }
+    ~ConcurrentBitmap() { for (Rank i = 0; i < SEGS; i++) delete[] seg[i].load(); }
+    void reserve(Rank n) {
+        for (unsigned long long k = 0; k < n; k += 1u << SEG_BITS) segment((Rank)k, true);
+    }
+    bool set(Rank k) {                   //test-and-setλǰֵ
+        Word m = 1ULL << (k & 63);
+        return segment(k, true)[(k >> 6) & (SEG_WORDS - 1)].fetch_or(m, memory_order_acq_rel) & m;
+    }
+    bool clear(Rank k) {                 //ǰֵ
+        atomic<Word>* p = segment(k, false);
+        if (!p) return false;
+        Word m = 1ULL << (k & 63);
+        return p[(k >> 6) & (SEG_WORDS - 1)].fetch_and(~m, memory_order_acq_rel) & m;
+    }
+    bool test(Rank k) const {
+        const atomic<Word>* p = segment(k);
+        return p && (p[(k >> 6) & (SEG_WORDS - 1)].load(memory_order_acquire) >> (k & 63) & 1);
+    }
+    Rank size() const {                  //޸ʱֻǽƿ
+        unsigned long long c = 0;
+        for (Rank i = 0; i < SEGS; i++) {
+            const atomic<Word>* p = seg[i].load(memory_order_acquire);
+            if (p) for (Rank j = 0; j < SEG_WORDS; j++) c += __builtin_popcountll(p[j].load(memory_order_relaxed));
+        }
+        return (Rank)c;
+    }
+};
+
 /*  BinTree */
 struct BinNode {
-    char ch;
-    int freq;
+    char ch;                     //ĸҶӵַĸҶΪ 0жҶҪ left
+    long long freq;              //ڲΪƵ֮ͣĸ»ᳬ int
+    int sym;                     //ҶӵķűţڲΪ -1
     BinNode *left, *right;
-    BinNode(char c = 0, int f = 0)
-        : ch(c), freq(f), left(NULL), right(NULL) {}
+    BinNode(char c = 0, long long f = 0, int s = -1)
+        : ch(c), freq(f), sym(s), left(NULL), right(NULL) {}
 };
 
 struct BinTree {
-    static void destroy(BinNode* x) {
-        if (!x) return;
-        destroy(x->left);
-        destroy(x->right);
-        delete x;
+    static void destroy(BinNode* x) {        //ʽջ˻Ҳջ
+        vector<BinNode*> stk;
+        if (x) stk.push_back(x);
+        while (!stk.empty()) {
+            BinNode* t = stk.back(); stk.pop_back();
+            if (t->left) stk.push_back(t->left);
+            if (t->right) stk.push_back(t->right);
+            delete t;
+        }
     }
 };
 
@@ -79,9 +546,9 @@ struct HuffTree {
     };
     static BinNode* build(const vector<int>& freq) {
         priority_queue<BinNode*, vector<BinNode*>, Cmp> pq;
-        for (int i = 0; i < 26; i++)
+        for (int i = 0; i < (int)freq.size(); i++)   //ǰ 26 Ϊĸ
             if (freq[i])
-                pq.push(new BinNode('a' + i, freq[i]));
+                pq.push(new BinNode(i < 26 ? 'a' + i : 0, freq[i], i));
         if (pq.empty()) return NULL;
         while (pq.size() > 1) {
             BinNode *l = pq.top(); pq.pop();
@@ -94,6 +561,60 @@ struct HuffTree {
     }
 };
 
+/* ĸ簴ʱ룩 HuffmanƵֻһΣ˫Ժϲ
+   ɵڲƵʵеĶ׼ȫС
+   һ±ָ룻볤ԸƳݹ */
+struct HuffArena {
+    struct Node {
+        long long freq;
+        int left, right;         //Ҷ left = -1right Ϊű
+    };
+    vector<Node> node;           //[0, m) ΪƵҶӣ֮Ϊڲ㣬
+    int leaves;
+    HuffArena() : leaves(0) {}
+    int root() const { return (int)node.size() - 1; }
+    void build(const vector<int>& freq) {    //ƵΪ 0 ķŲ
+        vector<unsigned long long> leaf, tmp;  // 32 λƵʡ 32 λ
+        leaf.reserve(freq.size());
+        for (int i = 0; i < (int)freq.size(); i++)
+            if (freq[i]) leaf.push_back((unsigned long long)(unsigned)freq[i] << 32 | (unsigned)i);
+        int m = leaves = (int)leaf.size();
+        tmp.resize(m);
+        for (int shift = 32; shift < 64; shift += 16) {        //Ƶ 16 λ
+            vector<int> cnt(65537, 0);
+            for (int i = 0; i < m; i++) cnt[(leaf[i] >> shift & 0xffff) + 1]++;
+            for (int d = 0; d < 65536; d++) cnt[d + 1] += cnt[d];
+            for (int i = 0; i < m; i++) tmp[cnt[leaf[i] >> shift & 0xffff]++] = leaf[i];
+            leaf.swap(tmp);
+        }
+        node.resize(m ? 2 * m - 1 : 0);
+        for (int i = 0; i < m; i++) {
+            node[i].freq = (long long)(leaf[i] >> 32);
+            node[i].left = -1;
+            node[i].right = (int)(unsigned)leaf[i];
+        }
+        int q1 = 0, q2 = m;                  //еĶףҶӡڲ
+        for (int k = m; k < 2 * m - 1; k++) {
+            int pick[2];
+            for (int t = 0; t < 2; t++)
+                pick[t] = (q2 >= k || (q1 < m && node[q1].freq <= node[q2].freq)) ? q1++ : q2++;
+            node[k].freq = node[pick[0]].freq + node[pick[1]].freq;
+            node[k].left = pick[0];
+            node[k].right = pick[1];
+        }
+    }
+    void codeLengths(vector<int>& len, int nSym) const {   //len[] = 볤δֵķΪ 0
+        len.assign(nSym, 0);
+        if (node.empty()) return;
+        vector<int> depth(node.size(), 0);
+        for (int k = root(); k >= leaves; k--) {            //±ܴӽ
+            depth[node[k].left] = depth[k] + 1;
+            depth[node[k].right] = depth[k] + 1;
+        }
+        for (int i = 0; i < leaves; i++) len[node[i].right] = depth[i];
+    }
+};
+
 /*  Bitmap  Huffman 봮 HuffCode */
 class HuffCode {
     Bitmap bm;
@@ -115,7 +636,7 @@ public:
 /* ɱ */
 void buildCodeMap(BinNode* x, string prefix, vector<string>& map) {
     if (!x) return;
-    if (x->ch) { map[x->ch - 'a'] = prefix; return; }
+    if (!x->left) { map[x->sym] = prefix; return; }
     buildCodeMap(x->left,  prefix + "0", map);
     buildCodeMap(x->right, prefix + "1", map);
 }
@@ -134,20 +655,250 @@ string encodeWord(const string& word, const vector<string>& codeMap) {
     }
     return hc.str();
 }
+
+/* дƵͳƣÿ̶ֱ߳ͼϲ */
+static void countFreqRange(const char* p, size_t n, vector<int>* out) {
+    int local[26] = {0};
+    for (size_t i = 0; i < n; ++i) {
+        char c = p[i];
+        if (c >= 'A' && c <= 'Z') c += 32;
+        if (c >= 'a' && c <= 'z') local[c - 'a']++;
+    }
+    out->assign(local, local + 26);
+}
+vector<int> countFreq(const char* text, size_t n, int nThreads = 0) {
+    if (nThreads <= 0) nThreads = max(1u, thread::hardware_concurrency());
+    size_t step = (n + nThreads - 1) / nThreads;
+    vector< vector<int> > part(nThreads);
+    vector<thread> pool;
+    for (int t = 0; t < nThreads; ++t) {
+        size_t lo = min(n, t * step), hi = min(n, lo + step);
+        pool.push_back(thread(countFreqRange, text + lo, hi - lo, &part[t]));
+    }
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+    vector<int> freq(26, 0);
+    for (int t = 0; t < nThreads; ++t)
+        for (int i = 0; i < 26; ++i) freq[i] += part[t][i];
+    return freq;
+}
+
+/* ֿ Huffman 밴 blockSize ĸп飬룬
+   ¼ÿʼλƫɲб벢һ顣
+   鰴ֽڶţ֤д뻥ֽڡ */
+struct HuffPack {
+    Rank blockSize;                       //ÿĸĩɲ㣩
+    vector<unsigned char> bits;           //MSB ȣ Bitmap λһ
+    vector<unsigned long long> bitOff;    // i ʼλƫ
+    vector<Rank> symCnt;                  // i ķ
+    Rank blocks() const { return (Rank)symCnt.size(); }
+};
+
+struct HuffBlockTask {                    //м
+    vector<unsigned char> buf;
+    unsigned long long nbit;
+};
+
+static void encodeBlockRange(const string* letters, Rank blockSize, const vector<string>* codeMap,
+                             vector<HuffBlockTask>* task, Rank from, Rank step) {
+    for (Rank b = from; b < task->size(); b += step) {
+        HuffBlockTask& t = (*task)[b];
+        size_t lo = (size_t)b * blockSize, hi = min(letters->size(), lo + blockSize);
+        t.nbit = 0;
+        for (size_t i = lo; i < hi; ++i) {
+            const string& code = (*codeMap)[(*letters)[i] - 'a'];
+            for (string::size_type j = 0; j < code.size(); ++j, ++t.nbit) {
+                if ((t.nbit & 7) == 0) t.buf.push_back(0);
+                if (code[j] == '1') t.buf.back() |= (0x80 >> (t.nbit & 7));
+            }
+        }
+    }
+}
+
+static void copyBlockRange(vector<HuffBlockTask>* task, HuffPack* pk, Rank from, Rank step) {
+    for (Rank b = from; b < task->size(); b += step) {
+        const vector<unsigned char>& buf = (*task)[b].buf;
+        if (!buf.empty()) memcpy(&pk->bits[pk->bitOff[b] >> 3], &buf[0], buf.size());
+    }
+}
+
+HuffPack encodeBlocks(const char* text, size_t n, const vector<string>& codeMap,
+                      Rank blockSize = 1 << 16, int nThreads = 0) {
+    if (nThreads <= 0) nThreads = max(1u, thread::hardware_concurrency());
+    string letters;                      // encodeWord һ£ֻĸдתСд
+    letters.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        char c = text[i];
+        if (c >= 'A' && c <= 'Z') c += 32;
+        if (c >= 'a' && c <= 'z') letters += c;
+    }
+    HuffPack pk;
+    pk.blockSize = blockSize;
+    Rank nb = (Rank)((letters.size() + blockSize - 1) / blockSize);
+    vector<HuffBlockTask> task(nb);
+    vector<thread> pool;
+    for (int t = 0; t < nThreads; ++t)
+        pool.push_back(thread(encodeBlockRange, &letters, blockSize, &codeMap, &task, (Rank)t, (Rank)nThreads));
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+
+    pk.bitOff.resize(nb);
+    pk.symCnt.resize(nb);
+    unsigned long long off = 0;          //ǰ׺͵õƫ
+    for (Rank b = 0; b < nb; ++b) {
+        pk.bitOff[b] = off;
+        pk.symCnt[b] = (Rank)(min(letters.size(), (size_t)(b + 1) * blockSize) - (size_t)b * blockSize);
+        off += (task[b].nbit + 7) / 8 * 8;
+    }
+    pk.bits.assign(off / 8, 0);
+    pool.clear();
+    for (int t = 0; t < nThreads; ++t)
+        pool.push_back(thread(copyBlockRange, &task, &pk, (Rank)t, (Rank)nThreads));
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+    return pk;
+}
+
+/* ʣ b 飬д out */
+void decodeBlock(const HuffPack& pk, BinNode* root, Rank b, char* out) {
+    unsigned long long k = pk.bitOff[b];
+    for (Rank i = 0; i < pk.symCnt[b]; ++i) {
+        BinNode* x = root;
+        while (x->left) {                //ĸҶӣλ
+            bool bit = pk.bits[k >> 3] & (0x80 >> (k & 7));
+            x = bit ? x->right : x->left;
+            ++k;
+        }
+        out[i] = x->ch;
+    }
+}
+
+static void decodeBlockRange(const HuffPack* pk, BinNode* root, string* out, Rank from, Rank step) {
+    for (Rank b = from; b < pk->blocks(); b += step)
+        decodeBlock(*pk, root, b, &(*out)[(size_t)b * pk->blockSize]);
+}
+
+string decodeBlocks(const HuffPack& pk, BinNode* root, int nThreads = 0) {
+    if (nThreads <= 0) nThreads = max(1u, thread::hardware_concurrency());
+    size_t total = 0;
+    for (Rank b = 0; b < pk.blocks(); ++b) total += pk.symCnt[b];
+    string out(total, 0);
+    if (!root) return out;
+    vector<thread> pool;
+    for (int t = 0; t < nThreads; ++t)
+        pool.push_back(thread(decodeBlockRange, &pk, root, &out, (Rank)t, (Rank)nThreads));
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+    return out;
+}
+
+static double wallMs() {
+    return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+/* RoaringBitmap  Bitmap Աȣڴ桢λѯ */
+void benchRoaring(const char* name, const vector<Rank>& ids, Rank range) {
+    Bitmap dense(range);
+    RoaringBitmap rb;
+    double t0 = wallMs();
+    for (size_t i = 0; i < ids.size(); i++) dense.set(ids[i]);
+    double t1 = wallMs();
+    for (size_t i = 0; i < ids.size(); i++) rb.set(ids[i]);
+    rb.runOptimize();
+    double t2 = wallMs();
+    unsigned hitD = 0, hitR = 0;
+    for (Rank k = 0; k < range; k += 97) hitD += dense.test(k);
+    double t3 = wallMs();
+    for (Rank k = 0; k < range; k += 97) hitR += rb.test(k);
+    double t4 = wallMs();
+    RoaringBitmap rc = rb;
+    rc.andWith(rb).orWith(rb);
+    double t5 = wallMs();
+    printf("%-8s n=%zu: Bitmap %u KB set %.1f ms test %.1f ms | Roaring %zu KB set %.1f ms test %.1f ms and+or %.1f ms %s\n",
+           name, ids.size(), dense.bytes() / 1024, t1 - t0, t3 - t2, rb.bytes() / 1024, t2 - t1, t4 - t3, t5 - t4,
+           (hitD == hitR && rc.size() == rb.size()) ? "OK" : "MISMATCH");
+}
+
+/* λͼԣ̶߳ص id  test-and-setռ Bitmap */
+static void csetWorker(ConcurrentBitmap* cb, Rank range, unsigned seed, int n, unsigned long long* first) {
+    unsigned long long cnt = 0;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        if (!cb->set(seed % range)) cnt++;
+    }
+    *first = cnt;
+}
+static void lsetWorker(Bitmap* bm, mutex* mu, Rank range, unsigned seed, int n, unsigned long long* first) {
+    unsigned long long cnt = 0;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        lock_guard<mutex> g(*mu);
+        Rank k = seed % range;
+        if (!bm->test(k)) { bm->set(k); cnt++; }
+    }
+    *first = cnt;
+}
+void benchConcurrent(int nThreads, Rank range, int perThread) {
+    ConcurrentBitmap cb;
+    Bitmap bm(range);
+    mutex mu;
+    vector<unsigned long long> f1(nThreads), f2(nThreads);
+    vector<thread> pool;
+    double t0 = wallMs();
+    for (int t = 0; t < nThreads; t++) pool.push_back(thread(csetWorker, &cb, range, 7u + t % 2, perThread, &f1[t]));
+    for (int t = 0; t < nThreads; t++) pool[t].join();
+    double t1 = wallMs();
+    pool.clear();
+    for (int t = 0; t < nThreads; t++) pool.push_back(thread(lsetWorker, &bm, &mu, range, 7u + t % 2, perThread, &f2[t]));
+    for (int t = 0; t < nThreads; t++) pool[t].join();
+    double t2 = wallMs();
+    unsigned long long s1 = 0, s2 = 0;
+    for (int t = 0; t < nThreads; t++) { s1 += f1[t]; s2 += f2[t]; }
+    printf("threads=%d ops=%d: atomic %.1f ms, mutex %.1f ms, unique %llu/%u %s\n", nThreads,
+           nThreads * perThread, t1 - t0, t2 - t1, s1, cb.size(), (s1 == cb.size() && s1 == s2) ? "OK" : "MISMATCH");
+}
+
+/* ĸHuffTreeȶ +  new˫ HuffArenaȽϼȨ볤֮ */
+void benchHuffBuild(int n) {
+    vector<int> freq(n);
+    for (int i = 0; i < n; i++) freq[i] = 100000000 / (i + 1) + 1;      // Zipf ֲ
+    for (int i = n - 1; i > 0; i--) swap(freq[i], freq[((unsigned)rand() * 65599u + (unsigned)rand()) % (i + 1)]);
+    double t0 = wallMs();                    //Ȳ HuffArenaHuffTree ͷǧСĴ
+    HuffArena ha;
+    ha.build(freq);
+    vector<int> len;
+    ha.codeLengths(len, n);
+    double t1 = wallMs();
+    unsigned long long cost2 = 0;
+    int maxLen = 0;
+    for (int i = 0; i < n; i++) {
+        cost2 += (unsigned long long)freq[i] * len[i];
+        maxLen = max(maxLen, len[i]);
+    }
+    double t2 = wallMs();
+    BinNode* root = HuffTree::build(freq);
+    double t3 = wallMs();
+    unsigned long long cost1 = 0;
+    vector<pair<BinNode*, int> > stk(1, make_pair(root, 0));
+    while (!stk.empty()) {
+        BinNode* x = stk.back().first;
+        int d = stk.back().second;
+        stk.pop_back();
+        if (!x->left) { cost1 += (unsigned long long)x->freq * d; continue; }
+        stk.push_back(make_pair(x->left, d + 1));
+        stk.push_back(make_pair(x->right, d + 1));
+    }
+    double t4 = wallMs();
+    BinTree::destroy(root);
+    double t5 = wallMs();
+    printf("symbols=%d: HuffTree build %.1f ms + destroy %.1f ms | HuffArena build+lengths %.1f ms, max len %d, cost %s\n",
+           n, t3 - t2, t5 - t4, t1 - t0, maxLen, cost1 == cost2 ? "OK" : "MISMATCH");
+}
+
 /*  */
-int main() {
+int main(int argc, char** argv) {
     const char* raw =
         "I have a dream that one day every valley shall be exalted "
         "and every hill and mountain shall be made low the rough places will be made plain "
         "and the crooked places will be made straight and the glory of the Lord shall be revealed "
         "and all flesh shall see it together";
 
-    vector<int> freq(26, 0);
-    for (const char* p = raw; *p; ++p) {
-        char c = *p;
-        if (c >= 'A' && c <= 'Z') c += 32;
-        if (c >= 'a' && c <= 'z') freq[c - 'a']++;
-    }
+    vector<int> freq = countFreq(raw, strlen(raw));
 
     BinNode* root = HuffTree::build(freq);
     if (!root) { puts("empty text"); return 0; }
@@ -164,6 +915,106 @@ int main() {
         cout << "Encode \"" << testWords[i]
              << "\": " << encodeWord(testWords[i], codeMap) << endl;
 
+    /* ֿ룺Сʾ */
+    HuffPack pk = encodeBlocks(raw, strlen(raw), codeMap, 32);
+    printf("\nBlocks: %u, total bits: %llu\n", pk.blocks(), (unsigned long long)pk.bits.size() * 8);
+    string blk(pk.symCnt[2], 0);
+    decodeBlock(pk, root, 2, &blk[0]);
+    printf("Block 2 @bit %llu: %s\n", pk.bitOff[2], blk.c_str());
+
+    /* Bitmap64λ㡢rank/select */
+    Bitmap64 ba, bb;
+    for (Rank k = 0; k < 200; k += 3) ba.set(k);
+    for (Rank k = 0; k < 200; k += 5) bb.set(k);
+    Bitmap64 bc = ba;
+    bc.andWith(bb);
+    printf("\nBitmap64: |A|=%u |B|=%u |A&B|=%u, A&B =", ba.size(), bb.size(), bc.size());
+    for (Rank k = bc.next(0); k != Bitmap64::NPOS; k = bc.next(k + 1)) printf(" %u", k);
+    ba.buildRank();
+    printf("\nrank(100)=%u select(10)=%u\n", ba.rank(100), ba.select(10));
+
+    /* RoaringBitmap4e9 λٷ GB ռ䣬л */
+    RoaringBitmap rbm;
+    rbm.set(4000000000u); rbm.set(7); rbm.set(8);
+    vector<unsigned char> ser = rbm.serialize();
+    RoaringBitmap rbm2;
+    rbm2.deserialize(ser);
+    printf("\nRoaring: size=%u bytes=%zu serialized=%zu test(4e9)=%d test(9)=%d\n",
+           rbm2.size(), rbm2.bytes(), ser.size(), rbm2.test(4000000000u), rbm2.test(9));
+
+    /* 𻵵ļγ̿飬 65530 101Խ 65535load() Ӧܾ */
+    const unsigned char bad[] = { 'R', 'B', 'M', '1', 1, 0, 0, 0,  0, 0,  RoaringBitmap::RUN,  101, 0, 0, 0,
+                                  2, 0, 0, 0,  0xFA, 0xFF,  100, 0 };
+    const char* badFile = "roaring_bad.bin";
+    FILE* bf = fopen(badFile, "wb");
+    if (bf) {
+        fwrite(bad, 1, sizeof(bad), bf);
+        fclose(bf);
+        RoaringBitmap rbm3;
+        bool ok = rbm3.load(badFile);
+        printf("Roaring load(ļ) = %d%s\n", ok, ok ? "󣺽˷Ƿγ" : "Ѿܾ");
+        remove(badFile);
+    }
+
+    if (argc < 2 || strcmp(argv[1], "--bench") != 0) {      //»׼ʱϳ --bench 
+        BinTree::destroy(root);
+        return 0;
+    }
+
+    /* ıб */
+    string big;
+    for (int i = 0; i < 20000; i++) big += raw;
+    double t0 = wallMs();
+    vector<int> bigFreq = countFreq(big.data(), big.size());
+    double t1 = wallMs();
+    HuffPack bigPk = encodeBlocks(big.data(), big.size(), codeMap);
+    double t2 = wallMs();
+    string dec = decodeBlocks(bigPk, root);
+    double t3 = wallMs();
+    string expect;
+    for (size_t i = 0; i < big.size(); i++) {
+        char c = big[i];
+        if (c >= 'A' && c <= 'Z') c += 32;
+        if (c >= 'a' && c <= 'z') expect += c;
+    }
+    printf("%zu bytes, %u blocks: freq %.2f ms, encode %.2f ms, decode %.2f ms, roundtrip %s\n",
+           big.size(), bigPk.blocks(), t1 - t0, t2 - t1, t3 - t2, dec == expect ? "OK" : "FAIL");
+
+    puts("\nLarge-alphabet Huffman build:");
+    for (int n = 1000000; n <= 10000000; n *= 10) benchHuffBuild(n);
+
+    /* Bitmap  Bitmap64 Ա */
+    const Rank NB = 1u << 26;
+    Bitmap bm8(NB);
+    Bitmap64 bm64(NB);
+    double tb0 = wallMs();
+    for (Rank k = 0; k < NB; k += 7) bm8.set(k);
+    unsigned cnt8 = 0;
+    for (Rank k = 0; k < NB; k++) cnt8 += bm8.test(k);
+    double tb1 = wallMs();
+    for (Rank k = 0; k < NB; k += 7) bm64.set(k);
+    unsigned cnt64 = 0;
+    for (Rank k = bm64.next(0); k != Bitmap64::NPOS; k = bm64.next(k + 1)) cnt64++;
+    double tb2 = wallMs();
+    printf("%u bits set+scan: Bitmap %.2f ms (%u), Bitmap64 %.2f ms (%u, popcount %u)\n",
+           NB, tb1 - tb0, cnt8, tb2 - tb1, cnt64, bm64.size());
+
+    /* RoaringBitmapϡ衢ܡγֲַ */
+    const Rank RANGE = 1u << 26;
+    vector<Rank> ids;
+    for (int i = 0; i < 100000; i++) ids.push_back((Rank)(((unsigned long long)rand() * 65599 + i) % RANGE));
+    benchRoaring("sparse", ids, RANGE);
+    ids.clear();
+    for (Rank k = 0; k < (1u << 22); k += 2) ids.push_back(k);
+    benchRoaring("dense", ids, 1u << 22);
+    ids.clear();
+    for (Rank k = 0; k < RANGE; k += 50000)
+        for (Rank j = 0; j < 1000; j++) ids.push_back(k + j);
+    benchRoaring("runs", ids, RANGE);
+
+    puts("\nConcurrentBitmap contention:");
+    for (int t = 1; t <= 8; t *= 2) benchConcurrent(t, 1u << 24, 1000000);
+
     BinTree::destroy(root);
     return 0;
 }
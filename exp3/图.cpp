@@ -7,10 +7,169 @@
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <climits>
+#include <ctime>
 using namespace std;
 
 const int INF = 0x3f3f3f3f;
 
+/* ܼ perf_trace.hʱ -DPERF_TRACE  */
+enum PerfId { PERF_EDGE_VISIT, PERF_HEAP_PUSH, PERF_STALE_POP, PERF_RELAX, PERF_N };
+static const char* const perfName[PERF_N] = { "edge_visit", "heap_push", "stale_pop", "relax" };
+#include "../perf_trace.h"
+
+/* ѹڽӱCSRu ھΪ dst[off[u] .. off[u+1])һ */
+struct CsrGraph {
+    int n;
+    vector<long long> off;
+    vector<int> dst;
+    long long edges() const { return (long long)dst.size() / 2; }
+};
+
+/* ͨlabel[v] ΪţССΪ 0, 1, ...size[c] Ϊ c Ķ */
+struct Components {
+    vector<int> label;
+    vector<int> size;
+};
+
+/* ֿ̬鲢У̴߳ӹȡһζ㣬R-MAT ֶбͼҲܾ⣻߳ʱֱڵǰ߳ */
+template <class F>
+void parallelFor(int n, int nThreads, F fn) {
+    const int CHUNK = 4096;
+    if (nThreads <= 1 || n <= CHUNK) {
+        for (int u = 0; u < n; ++u) fn(u);
+        return;
+    }
+    atomic<int> next(0);
+    vector<thread> pool;
+    for (int t = 0; t < nThreads; ++t)
+        pool.push_back(thread([&]() {
+            for (int b; (b = next.fetch_add(CHUNK)) < n; )
+                for (int u = b, e = min(n, b + CHUNK); u < e; ++u) fn(u);
+        }));
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+}
+
+/* 鼯parent ָֻСıţԸǼڵС
+   find  CAS ·루ʧ˵߳ѸĹֱɣ
+   unite  CAS ѽϴĸҵСĸ£CAS ʧ˵ѱ˹ߣҸ */
+class ConcurrentDSU {
+public:
+    explicit ConcurrentDSU(int n) : parent(n) {
+        for (int i = 0; i < n; ++i) parent[i].store(i, memory_order_relaxed);
+    }
+    int find(int x) {
+        while (true) {
+            int p = parent[x].load(memory_order_relaxed);
+            if (p == x) return x;
+            int gp = parent[p].load(memory_order_relaxed);
+            if (p != gp) parent[x].compare_exchange_weak(p, gp, memory_order_relaxed);
+            x = gp;
+        }
+    }
+    void unite(int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+            if (a < b) swap(a, b);
+            int expect = a;
+            if (parent[a].compare_exchange_strong(expect, b, memory_order_acq_rel)) return;
+        }
+    }
+    /* ֻûв unite ʱã x ֱָ */
+    void compress(int x) { parent[x].store(find(x), memory_order_relaxed); }
+    int parentOf(int x) const { return parent[x].load(memory_order_relaxed); }
+    /*  samples 㣬سĸʵ */
+    int sampleLargest(int samples) {
+        int n = (int)parent.size();
+        vector<int> roots;
+        unsigned long long r = 88172645463325252ULL;
+        for (int i = 0; i < samples; ++i) {
+            r ^= r << 13; r ^= r >> 7; r ^= r << 17;
+            roots.push_back(find((int)(r % (unsigned long long)n)));
+        }
+        sort(roots.begin(), roots.end());
+        int best = roots[0], bestCnt = 0;
+        for (size_t i = 0, j; i < roots.size(); i = j) {
+            for (j = i; j < roots.size() && roots[j] == roots[i]; ++j) {}
+            if ((int)(j - i) > bestCnt) { bestCnt = (int)(j - i); best = roots[i]; }
+        }
+        return best;
+    }
+private:
+    vector< atomic<int> > parent;
+};
+
+/* Afforest ʽͨ
+   1. ÿֻǰ ROUNDS ߣѹһΣ󲿷ֶѾշ
+   2. ҳԱʣȫͼǶԳƴ洢ģı߻һ˱
+   3. ඥʣµı꣬ѹ */
+Components connectedComponents(const CsrGraph& g, int nThreads) {
+    PERF_SPAN("components");
+    const int ROUNDS = 2;
+    int n = g.n;
+    Components cc;
+    if (n == 0) return cc;
+    ConcurrentDSU dsu(n);
+    for (int r = 0; r < ROUNDS; ++r) {
+        parallelFor(n, nThreads, [&](int u) {
+            if (g.off[u] + r < g.off[u + 1]) dsu.unite(u, g.dst[g.off[u] + r]);
+        });
+        parallelFor(n, nThreads, [&](int u) { dsu.compress(u); });
+    }
+    int big = dsu.sampleLargest(1024);
+    parallelFor(n, nThreads, [&](int u) {
+        if (dsu.parentOf(u) == big) return;
+        for (long long i = g.off[u] + ROUNDS; i < g.off[u + 1]; ++i) dsu.unite(u, g.dst[i]);
+    });
+    parallelFor(n, nThreads, [&](int u) { dsu.compress(u); });
+
+    cc.label.resize(n);
+    for (int v = 0; v < n; ++v) {                // ǷС㣬ڳԱ
+        int r = dsu.parentOf(v);
+        if (r == v) {
+            cc.label[v] = (int)cc.size.size();
+            cc.size.push_back(0);
+        } else {
+            cc.label[v] = cc.label[r];
+        }
+        ++cc.size[cc.label[v]];
+    }
+    return cc;
+}
+
+/* ʵ֣˳ BFS visitedŹ벢鼯ͬ */
+Components componentsBfs(const CsrGraph& g) {
+    PERF_SPAN("componentsBfs");
+    Components cc;
+    cc.label.assign(g.n, -1);
+    vector<int> q(g.n);
+    for (int s = 0; s < g.n; ++s) {
+        if (cc.label[s] != -1) continue;
+        int c = (int)cc.size.size(), head = 0, tail = 0;
+        cc.label[s] = c;
+        q[tail++] = s;
+        while (head < tail) {
+            int u = q[head++];
+            PERF_ADD(PERF_EDGE_VISIT, g.off[u + 1] - g.off[u]);
+            for (long long i = g.off[u]; i < g.off[u + 1]; ++i)
+                if (cc.label[g.dst[i]] == -1) {
+                    cc.label[g.dst[i]] = c;
+                    q[tail++] = g.dst[i];
+                }
+        }
+        cc.size.push_back(tail);
+    }
+    return cc;
+}
+
 /* ͼ */
 class Graph {
 public:
@@ -55,6 +214,7 @@ public:
 
     /* BFS */
     vector<int> bfs(int src) const {
+        PERF_SPAN("bfs");
         vector<int> order;
         vector<bool> vis(n, false);
         queue<int> q;
@@ -63,6 +223,7 @@ public:
         while (!q.empty()) {
             int u = q.front(); q.pop();
             order.push_back(u);
+            PERF_ADD(PERF_EDGE_VISIT, adj[u].size());
             for (vector< pair<int,int> >::const_iterator it = adj[u].begin(); it != adj[u].end(); ++it)
                 if (!vis[it->first]) {
                     vis[it->first] = true;
@@ -74,6 +235,7 @@ public:
 
     /* DFS */
     vector<int> dfs(int src) const {
+        PERF_SPAN("dfs");
         vector<int> order;
         vector<bool> vis(n, false);
         stack<int> st;
@@ -82,6 +244,7 @@ public:
         while (!st.empty()) {
             int u = st.top(); st.pop();
             order.push_back(u);
+            PERF_ADD(PERF_EDGE_VISIT, adj[u].size());
             for (vector< pair<int,int> >::const_reverse_iterator it = adj[u].rbegin(); it != adj[u].rend(); ++it)
                 if (!vis[it->first]) {
                     vis[it->first] = true;
@@ -93,19 +256,27 @@ public:
 
     /* Dijkstra */
     vector<int> dijkstra(int src) const {
+        PERF_SPAN("dijkstra");
         vector<int> dist(n, INF);
         priority_queue< pair<int,int>, vector< pair<int,int> >, greater< pair<int,int> > > pq;
         dist[src] = 0;
         pq.push(make_pair(0, src));
+        PERF_ADD(PERF_HEAP_PUSH, 1);
         while (!pq.empty()) {
             pair<int,int> top = pq.top(); pq.pop();
             int d = top.first, u = top.second;
-            if (d > dist[u]) continue;
+            if (d > dist[u]) {
+                PERF_ADD(PERF_STALE_POP, 1);
+                continue;
+            }
+            PERF_ADD(PERF_EDGE_VISIT, adj[u].size());
             for (vector< pair<int,int> >::const_iterator it = adj[u].begin(); it != adj[u].end(); ++it) {
                 int v = it->first, w = it->second;
                 if (dist[v] > dist[u] + w) {
                     dist[v] = dist[u] + w;
                     pq.push(make_pair(dist[v], v));
+                    PERF_ADD(PERF_RELAX, 1);
+                    PERF_ADD(PERF_HEAP_PUSH, 1);
                 }
             }
         }
@@ -114,22 +285,30 @@ public:
 
     /* Prim */
     vector< pair<int,int> > prim(int src = 0) const {
+        PERF_SPAN("prim");
         vector<bool> inMST(n, false);
         vector<int> lowCost(n, INF), parent(n, -1);
         lowCost[src] = 0;
         priority_queue< pair<int,int>, vector< pair<int,int> >, greater< pair<int,int> > > pq;
         pq.push(make_pair(0, src));
+        PERF_ADD(PERF_HEAP_PUSH, 1);
         while (!pq.empty()) {
             pair<int,int> top = pq.top(); pq.pop();
             int u = top.second;
-            if (inMST[u]) continue;
+            if (inMST[u]) {
+                PERF_ADD(PERF_STALE_POP, 1);
+                continue;
+            }
             inMST[u] = true;
+            PERF_ADD(PERF_EDGE_VISIT, adj[u].size());
             for (vector< pair<int,int> >::const_iterator it = adj[u].begin(); it != adj[u].end(); ++it) {
                 int v = it->first, w = it->second;
                 if (!inMST[v] && w < lowCost[v]) {
                     lowCost[v] = w;
                     parent[v] = u;
                     pq.push(make_pair(w, v));
+                    PERF_ADD(PERF_RELAX, 1);
+                    PERF_ADD(PERF_HEAP_PUSH, 1);
                 }
             }
         }
@@ -139,10 +318,28 @@ public:
         return edges;
     }
 
+    /* ת CSR */
+    CsrGraph toCsr() const {
+        CsrGraph g;
+        g.n = n;
+        g.off.assign(n + 1, 0);
+        for (int u = 0; u < n; ++u) g.off[u + 1] = g.off[u] + (long long)adj[u].size();
+        g.dst.resize(g.off[n]);
+        for (int u = 0; u < n; ++u)
+            for (size_t i = 0; i < adj[u].size(); ++i) g.dst[g.off[u] + i] = adj[u][i].first;
+        return g;
+    }
+
+    /* ͨ鼯 */
+    Components components(int nThreads = 1) const {
+        return connectedComponents(toCsr(), nThreads);
+    }
+
     /* Tarjan BCC +  */
     vector<int> cutVertex;
     vector< vector< pair<int,int> > > bcc;
     void tarjanBCC() {
+        PERF_SPAN("tarjanBCC");
         cutVertex.clear();
         bcc.clear();
         int idx = 0;
@@ -157,6 +354,7 @@ private:
         dfn[u] = low[u] = idx++;
         int child = 0;
         bool isCut = false;
+        PERF_ADD(PERF_EDGE_VISIT, adj[u].size());
         for (vector< pair<int,int> >::const_iterator it = adj[u].begin(); it != adj[u].end(); ++it) {
             int v = it->first;
             if (v == fa) continue;
@@ -185,11 +383,144 @@ private:
     }
 };
 
+/* 齨 CSRgen(emit) ܰͬһ˳طűУһֻڶھӣʡ m ߵʱ */
+template <class Gen>
+CsrGraph buildCsr(int n, const Gen& gen) {
+    CsrGraph g;
+    g.n = n;
+    g.off.assign(n + 1, 0);
+    gen([&](int u, int v) { ++g.off[u + 1]; ++g.off[v + 1]; });
+    for (int i = 0; i < n; ++i) g.off[i + 1] += g.off[i];
+    g.dst.resize(g.off[n]);
+    vector<long long> pos(g.off.begin(), g.off.end() - 1);
+    gen([&](int u, int v) { g.dst[pos[u]++] = v; g.dst[pos[v]++] = u; });
+    return g;
+}
+
+/* splitmix64õĿط */
+struct SplitMix {
+    unsigned long long x;
+    explicit SplitMix(unsigned long long seed) : x(seed) {}
+    unsigned long long next() {
+        unsigned long long z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+/* R-MAT2^scale 㡢m ߣ޸ȡ Graph500  a=0.57, b=c=0.19, d=0.05
+   ÿ 16 λѡޣһ 64 λ 4 㡣Իر߱Ӱͨ */
+struct RmatGen {
+    int scale;
+    long long m;
+    unsigned long long seed;
+    template <class Emit>
+    void operator()(Emit emit) const {
+        const unsigned A = 37355, AB = A + 12452, ABC = AB + 12452;     // 0.57, 0.19, 0.19  65536
+        SplitMix rng(seed);
+        for (long long e = 0; e < m; ++e) {
+            int u = 0, v = 0;
+            unsigned long long bits = 0;
+            for (int lv = 0; lv < scale; ++lv) {
+                if (lv % 4 == 0) bits = rng.next();
+                unsigned r = (unsigned)(bits & 0xFFFF);
+                bits >>= 16;
+                int ab = r >= AB;                                           // ޷֧ѡޣ֧Ԥʧ
+                u = u << 1 | ab;
+                v = v << 1 | ((r >= A) ^ ab ^ (r >= ABC));
+            }
+            emit(u, v);
+        }
+    }
+};
+
+/* 2-D rows x colsÿҡھӣÿ keep ĸʱkeep  0.5 ʱС */
+struct GridGen {
+    int rows, cols;
+    double keep;
+    unsigned long long seed;
+    template <class Emit>
+    void operator()(Emit emit) const {
+        unsigned long long th = (unsigned long long)(keep * 4294967296.0);
+        SplitMix rng(seed);
+        for (int r = 0; r < rows; ++r)
+            for (int c = 0; c < cols; ++c) {
+                int u = r * cols + c;
+                unsigned long long bits = rng.next();
+                if (c + 1 < cols && (bits & 0xFFFFFFFFULL) < th) emit(u, u + 1);
+                if (r + 1 < rows && (bits >> 32) < th) emit(u, u + cols);
+            }
+    }
+};
+
+CsrGraph genRmat(long long m, unsigned long long seed) {
+    int scale = 1;                                   // ƽԼ 16 ӦĹģ
+    while ((1LL << (scale + 1)) * 8 <= m && scale < 30) ++scale;
+    RmatGen gen = { scale, m, seed };
+    return buildCsr(1 << scale, gen);
+}
+
+/*  side*side  int ʱؿͼn = 0ɵ÷ */
+CsrGraph genGrid(long long m, double keep, unsigned long long seed) {
+    long long side = max(1LL, (long long)sqrt((double)m / (2 * keep)));
+    if (side * side > INT_MAX) {
+        CsrGraph empty;
+        empty.n = 0;
+        empty.off.assign(1, 0);
+        return empty;
+    }
+    GridGen gen = { (int)side, (int)side, keep, seed };
+    return buildCsr((int)(side * side), gen);
+}
+
+bool sameComponents(const Components& a, const Components& b) {
+    return a.label == b.label && a.size == b.size;
+}
+
+double nowMs() {
+    return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* ͼ׼ R-MAT ͼBFS ա̲߳߳鼯ֱʱ˶ */
+void benchComponents(const string& kind, long long m, int nThreads) {
+    double t0 = nowMs();
+    CsrGraph g = kind == "grid" ? genGrid(m, 0.5, 2025) : genRmat(m, 2025);
+    if (g.n == 0) { cout << kind << "m = " << m << " 󣬶 int Χ" << endl; return; }
+    double mb = (g.off.size() * sizeof(long long) + g.dst.size() * sizeof(int)) / 1048576.0;
+    cout << kind << "n = " << g.n << "m = " << g.edges() << "CSR " << fixed << setprecision(0) << mb
+         << " MB " << nowMs() - t0 << " ms" << endl;
+
+    t0 = nowMs();
+    Components ref = componentsBfs(g);
+    double t1 = nowMs();
+    Components one = connectedComponents(g, 1);
+    double t2 = nowMs();
+    Components par = connectedComponents(g, nThreads);
+    double t3 = nowMs();
+    int largest = *max_element(ref.size.begin(), ref.size.end());
+    cout << " = " << ref.size.size() << " = " << largest << endl;
+    cout << "BFS գ" << t1 - t0 << " ms" << endl;
+    cout << "鼯 1 ̣߳" << t2 - t1 << " ms" << (sameComponents(one, ref) ? "һ" : "һ") << endl;
+    cout << "鼯 " << nThreads << " ̣߳" << t3 - t2 << " ms" << (sameComponents(par, ref) ? "һ" : "һ") << endl;
+}
+
 /*  */
-int main() {
+int main(int argc, char** argv) {
     ios::sync_with_stdio(false);
     cin.tie(NULL);
 
+    unsigned seed = (unsigned)time(NULL);
+    if (argc > 2 && strcmp(argv[1], "--seed") == 0)      // ͼ --seed <>طĳ
+        seed = (unsigned)strtoul(argv[2], NULL, 10);
+    if (argc > 1 && strcmp(argv[1], "--cc") == 0) {     // ͼ --cc [rmat|grid] [] [߳]
+        string kind = argc > 2 ? argv[2] : "rmat";
+        long long m = argc > 3 ? (long long)atof(argv[3]) : 100000000LL;
+        int nThreads = argc > 4 ? atoi(argv[4]) : (int)max(1u, thread::hardware_concurrency());
+        benchComponents(kind, m, nThreads);
+        return 0;
+    }
+
     /* ͼ1 */
     Graph g1;
     const string nodes[] = {"A", "B", "C", "D", "E", "F", "G", "H"};
@@ -286,5 +617,39 @@ int main() {
         if (now != ref) same = false;
     }
     cout << "ͬõĸ㼯Ƿһ£" << (same ? "" : "") << "\n";
+
+    /* ͨϡͼеȹģ R-MAT / ͼ鼯 BFS նգ
+        parallelFor ķֿС 4096߳ʱȷʵж̲߳ unite */
+    cout << "\n---- ͨԣ " << seed << "----\n";
+    srand(seed);
+    for (int t = 1; t <= 10; ++t) {
+        Graph g;
+        int n = 4097 + rand() % 16000, m = rand() % (2 * n);
+        for (int i = 0; i < n; ++i) {
+            ostringstream oss; oss << "v" << i;
+            g.name2id[oss.str()] = g.n++;
+            g.id2name.push_back(oss.str());
+        }
+        g.adj.resize(g.n);
+        for (int i = 0; i < m; ++i) {
+            int a = rand() % n, b = rand() % n;
+            g.adj[a].push_back(make_pair(b, 1));
+            g.adj[b].push_back(make_pair(a, 1));
+        }
+        int nThreads = 2 + rand() % 3;
+        Components cc = g.components(nThreads);
+        bool ok = sameComponents(cc, componentsBfs(g.toCsr()));
+        cout << " " << t << " 飺n = " << n << "m = " << m << " = " << cc.size.size()
+             << "" << nThreads << " ̲߳鼯 BFS " << (ok ? "һ" : "һ") << "\n";
+    }
+    for (int t = 1; t <= 4; ++t) {
+        long long m = 140000 + rand() % 200000;           // R-MAT  2^13 
+        CsrGraph g = t % 2 ? genRmat(m, rand()) : genGrid(m, 0.3 + 0.1 * t, rand());
+        int nThreads = 2 + rand() % 3;
+        Components cc = connectedComponents(g, nThreads);
+        cout << (t % 2 ? "R-MAT" : "") << "n = " << g.n << "m = " << g.edges() << " = " << cc.size.size()
+             << "" << nThreads << " ̲߳鼯 BFS " << (sameComponents(cc, componentsBfs(g)) ? "һ" : "һ") << "\n";
+    }
+    PERF_DUMP("graph_trace.json");
     return 0;
 }
@@ -5,12 +5,33 @@
 #include <ctime>
 #include <cmath>
 
+/* ܼ perf_trace.hʱ -DPERF_TRACE PERF_CMP ֵȽϱʽͬʱһαȽ */
+enum PerfId { PERF_SORT_CMP, PERF_SORT_MOVE, PERF_NMS_IOU, PERF_NMS_SUPPRESS, PERF_N };
+static const char* const perfName[PERF_N] = { "sort_cmp", "sort_move", "nms_iou", "nms_suppress" };
+#include "../perf_trace.h"
+#ifdef PERF_TRACE
+#define PERF_CMP(expr)   (++perfCnt[PERF_SORT_CMP], (expr))
+#else
+#define PERF_CMP(expr)   (expr)
+#endif
+
 /* ݽṹ */
 struct BBox {                   //洢߽ϢꡢŶȡš  
     float x1, y1, x2, y2;
     float score;
     int   id;
     float area() const { return (x2 - x1) * (y2 - y1); }
+#ifdef PERF_TRACE
+    BBox() {}                   //ʱÿο STL ڲİƣһ move
+    BBox(const BBox& o) : x1(o.x1), y1(o.y1), x2(o.x2), y2(o.y2), score(o.score), id(o.id) {
+        PERF_ADD(PERF_SORT_MOVE, 1);
+    }
+    BBox& operator=(const BBox& o) {
+        x1 = o.x1; y1 = o.y1; x2 = o.x2; y2 = o.y2; score = o.score; id = o.id;
+        PERF_ADD(PERF_SORT_MOVE, 1);
+        return *this;
+    }
+#endif
 };
 
 /* ײʵ */
@@ -19,8 +40,8 @@ void quickSort(std::vector<BBox>& a, int l, int r) {     //
     float pivot = a[l + rand() % (r - l + 1)].score;
     int i = l, j = r;
     while (i <= j) {
-        while (a[i].score < pivot) ++i;
-        while (a[j].score > pivot) --j;
+        while (PERF_CMP(a[i].score < pivot)) ++i;
+        while (PERF_CMP(a[j].score > pivot)) --j;
         if (i <= j) std::swap(a[i++], a[j--]);
     }
     if (l < j) quickSort(a, l, j);
@@ -34,14 +55,14 @@ void mergeSort(std::vector<BBox>& a, int l, int r, std::vector<BBox>& tmp) {
     mergeSort(a, m + 1, r, tmp);
     int i = l, j = m + 1, k = l;
     while (i <= m && j <= r)
-        tmp[k++] = (a[i].score < a[j].score) ? a[i++] : a[j++];
+        tmp[k++] = PERF_CMP(a[i].score < a[j].score) ? a[i++] : a[j++];
     while (i <= m) tmp[k++] = a[i++];
     while (j <= r) tmp[k++] = a[j++];
     for (i = l; i <= r; ++i) a[i] = tmp[i];
 }
 
 struct CmpGreater {
-    bool operator()(const BBox& a, const BBox& b) const { return a.score > b.score; }
+    bool operator()(const BBox& a, const BBox& b) const { return PERF_CMP(a.score > b.score); }
 };
 void heapSort(std::vector<BBox>& a) {          //
     std::make_heap(a.begin(), a.end(), CmpGreater());
@@ -59,7 +80,7 @@ void shellSort(std::vector<BBox>& a) {        //ϣ
         for (int i = h; i < n; ++i) {
             BBox key = a[i];
             int j = i;
-            while (j >= h && a[j - h].score > key.score) {
+            while (j >= h && PERF_CMP(a[j - h].score > key.score)) {
                 a[j] = a[j - h];
                 j -= h;
             }
@@ -84,7 +105,11 @@ void shellSortWrap(std::vector<BBox>& a) { shellSort(a); }
 /* NMS */
 std::vector<BBox> nms(std::vector<BBox> boxes, float iouTh = 0.5f) {
     if (boxes.empty()) return std::vector<BBox>();
-    std::sort(boxes.begin(), boxes.end(), CmpGreater());
+    {
+        PERF_SPAN("nms/sort");
+        std::sort(boxes.begin(), boxes.end(), CmpGreater());
+    }
+    PERF_SPAN("nms/suppress");
     std::vector<BBox> keep;
     std::vector<bool> supp(boxes.size(), false);
     for (int i = 0; i < (int)boxes.size(); ++i) {
@@ -99,7 +124,11 @@ std::vector<BBox> nms(std::vector<BBox> boxes, float iouTh = 0.5f) {
             float w = std::max(0.0f, xx2 - xx1), h = std::max(0.0f, yy2 - yy1);
             float inter = w * h;
             float iou   = inter / (a.area() + b.area() - inter);
-            if (iou > iouTh) supp[j] = true;
+            PERF_ADD(PERF_NMS_IOU, 1);
+            if (iou > iouTh) {
+                supp[j] = true;
+                PERF_ADD(PERF_NMS_SUPPRESS, 1);
+            }
         }
     }
     return keep;
@@ -150,7 +179,11 @@ struct SorterEntry {
 
 int main() {
     srand((unsigned)time(NULL));
+#ifdef PERF_TRACE
+    printf("sort,dataDist,n,keep,tNMS,tSort,cmp,moves,iou,suppressed\n");
+#else
     printf("sort,dataDist,n,keep,tNMS,tSort\n");
+#endif
 
     int sizes[] = {100, 1000, 10000};
     const char* dists[] = {"random", "cluster"};
@@ -168,19 +201,37 @@ int main() {
             std::vector<BBox> boxes = (di == 0) ? genRandom(n) : genCluster(n);
             for (int ki = 0; ki < 4; ++ki) {
                 std::vector<BBox> tmp = boxes;
+                PERF_RESET();
                 double t0 = tick();
-                sorters[ki].sort(tmp);
+                {
+                    PERF_SPAN("sort/%s/%s/%d", sorters[ki].name, dists[di], n);
+                    sorters[ki].sort(tmp);
+                }
                 double tSort = tick() - t0;
+#ifdef PERF_TRACE
+                unsigned long long cmp = perfCnt[PERF_SORT_CMP], moves = perfCnt[PERF_SORT_MOVE];
+#endif
 
                 std::reverse(tmp.begin(), tmp.end());
+                PERF_RESET();
                 t0 = tick();
-                tmp = nms(tmp);
+                {
+                    PERF_SPAN("nms/%s/%s/%d", sorters[ki].name, dists[di], n);
+                    tmp = nms(tmp);
+                }
                 double tNMS = tick() - t0;
 
+#ifdef PERF_TRACE
+                printf("%s,%s,%d,%d,%.2f,%.2f,%llu,%llu,%llu,%llu\n",
+                       sorters[ki].name, dists[di], n, (int)tmp.size(), tNMS, tSort,
+                       cmp, moves, perfCnt[PERF_NMS_IOU], perfCnt[PERF_NMS_SUPPRESS]);
+#else
                 printf("%s,%s,%d,%d,%.2f,%.2f\n",
                        sorters[ki].name, dists[di], n, (int)tmp.size(), tNMS, tSort);
+#endif
             }
         }
     }
+    PERF_DUMP("sort_trace.json");
     return 0;
 }
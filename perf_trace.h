@@ -0,0 +1,82 @@
+/* ܼ׷٣exp3exp4 
+   ÷ԴļﶨԼ enum PerfId { ..., PERF_N } ͼ perfName[PERF_N]ٰļ
+   ʱ -DPERF_TRACE ĺȫչΪգ·ûκζ⿪
+   PERF_ADD ۼӼPERF_SPAN ¼ֹʱڼ
+   PERF_DUMP д Chrome trace ʽ JSONchrome://tracing  Perfetto 򿪣 stderr ӡ */
+#ifndef PERF_TRACE_H
+#define PERF_TRACE_H
+
+#ifdef PERF_TRACE
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+
+static unsigned long long perfCnt[PERF_N];
+struct PerfEvent {
+    std::string name;
+    double ts, dur;                          //΢
+    unsigned long long delta[PERF_N];
+};
+static std::vector<PerfEvent> perfEvents;
+static double perfNowUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+struct PerfSpan {
+    PerfEvent ev;
+    explicit PerfSpan(const char* fmt, ...) {
+        char buf[128];
+        va_list ap;
+        va_start(ap, fmt);
+        vsnprintf(buf, sizeof buf, fmt, ap);
+        va_end(ap);
+        ev.name = buf;
+        memcpy(ev.delta, perfCnt, sizeof perfCnt);
+        ev.ts = perfNowUs();
+    }
+    ~PerfSpan() {
+        ev.dur = perfNowUs() - ev.ts;
+        for (int i = 0; i < PERF_N; ++i) ev.delta[i] = perfCnt[i] - ev.delta[i];
+        perfEvents.push_back(ev);
+    }
+};
+static void perfDumpTrace(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "trace: ޷д %s\n", path);
+        return;
+    }
+    fprintf(f, "{\"traceEvents\":[");
+    fprintf(stderr, "\n---- ܼ ----\n");
+    for (size_t i = 0; i < perfEvents.size(); ++i) {
+        const PerfEvent& e = perfEvents[i];
+        fprintf(f, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{",
+                i ? "," : "", e.name.c_str(), e.ts, e.dur);
+        fprintf(stderr, "%-32s %10.1fus", e.name.c_str(), e.dur);
+        for (int k = 0; k < PERF_N; ++k) {
+            fprintf(f, "%s\"%s\":%llu", k ? "," : "", perfName[k], e.delta[k]);
+            if (e.delta[k]) fprintf(stderr, "  %s=%llu", perfName[k], e.delta[k]);
+        }
+        fprintf(f, "}}");
+        fprintf(stderr, "\n");
+    }
+    fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(f);
+    fprintf(stderr, "trace: %zu spans -> %s\n", perfEvents.size(), path);
+}
+#define PERF_ADD(id, k)  (perfCnt[id] += (k))
+#define PERF_RESET()     memset(perfCnt, 0, sizeof perfCnt)
+#define PERF_CAT2(a, b)  a##b
+#define PERF_CAT(a, b)   PERF_CAT2(a, b)
+#define PERF_SPAN(...)   PerfSpan PERF_CAT(perfSpan_, __LINE__)(__VA_ARGS__)
+#define PERF_DUMP(path)  perfDumpTrace(path)
+#else
+#define PERF_ADD(id, k)  ((void)0)
+#define PERF_RESET()     ((void)0)
+#define PERF_SPAN(...)   ((void)0)
+#define PERF_DUMP(path)  ((void)0)
+#endif
+
+#endif